@@ -7,7 +7,9 @@
 #include <SDL2/SDL_ttf.h>
 #include <GL/glew.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <pthread.h>
+#include <sched.h>
 
 #include "graph.h"
 #include "shader.h"
@@ -16,6 +18,10 @@
 #include "curve.h"
 #include "screenshot.h"
 #include "button.h"
+#include "updater.h"
+#include "wakeup.h"
+#include "render.h"
+#include "vertex_arena.h"
 
 
 
@@ -53,10 +59,44 @@ static double duration;		///< Total duration of the simulation.
 static double timestep;		///< Timestep between two updates.
 static uint64_t iteration;		///< Current iteration number.
 static uint64_t max_iteration;	///< Max iteration number.
+static int update_threads;		///< Number of threads used to update the curves.
+static int update_catchup;		///< Max number of late updates run at once.
+static bool fast_forward;		///< true if all the updates are run before the window is shown.
+static bool headless;			///< true if argus_show only saves screenshots of the graphs.
+
+// Path of the file where the glyphs atlas is cached, or NULL.
+static char *glyphs_cache;
 
 // Main mutex used to make the library thread safe.
 static pthread_mutex_t argus_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// true while argus_show runs. The graphs and the current curve can't change during that time,
+// so the curve data functions use it to stream their data without taking argus_mutex.
+static atomic_bool showing = false;
+
+// Target of the argus_curve_add_* functions while the window is shown.
+// Written under argus_mutex before showing is set, so the streaming threads read it without the lock.
+static Curve *show_curve = NULL;	///< The curve that was current when the window was shown, or NULL.
+static Graph *show_graph = NULL;	///< The graph that was current when the window was shown.
+
+// Serializes the argus_curve_add_* functions while the window is shown, since the stream queues
+// of show_curve only have one producer. argus_show never takes it, so it doesn't block the render.
+static pthread_mutex_t stream_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/// @struct ArgusStream
+/// @brief A handle streaming data into a curve from the thread that opened it.
+/// @note A curve has at most one opened handle, so its stream queues only ever have one producer.
+struct ArgusStream {
+	Curve *curve;		///< The curve the data is streamed into.
+	Graph *graph;		///< The graph of the curve, notified of the new data.
+	pthread_t owner;	///< The only thread allowed to stream through the handle.
+};
+
+// Latency between a notification of new data and the swap that shows it, in nanoseconds.
+// Written by the render loop and read without argus_mutex, which argus_show keeps.
+static atomic_uint_fast64_t render_latency;		///< Latency of the last swap showing new data.
+static atomic_uint_fast64_t max_render_latency;	///< Max latency since the window was shown.
+
 // Macro to check if the module was initialized.
 #define CHECK_INIT(init, mutex, ...) do { \
     pthread_mutex_lock(&mutex); \
@@ -67,6 +107,24 @@ static pthread_mutex_t argus_mutex = PTHREAD_MUTEX_INITIALIZER;
     } \
 } while(0);
 
+// Macro to check if the module was initialized, or to run the given streaming code while the window is shown.
+// argus_show keeps the mutex during the whole show, so the mutex is only tried, and showing is checked
+// again after each failure, instead of waiting for the end of the show.
+#define CHECK_INIT_OR_STREAM(init, mutex, ...) do { \
+    while (atomic_load(&showing) || pthread_mutex_trylock(&mutex)) { \
+        if (atomic_load(&showing)) { \
+            __VA_ARGS__ \
+            return; \
+        } \
+        sched_yield(); \
+    } \
+    if (!(init)) { \
+        fprintf(stderr, "[ARGUS]: fatal: not initialized !\n"); \
+        pthread_mutex_unlock(&mutex); \
+        return; \
+    } \
+} while(0);
+
 // Macro to get the current graph.
 #define CURRENT_GRAPH grid[current_line*columns+current_column]
 
@@ -143,10 +201,15 @@ void argus_init() {
 	timestep = 0.0f;
 	iteration = 0;
 	max_iteration = 0;
+	update_threads = 1;
+	update_catchup = 8;
+	fast_forward = false;
+	headless = false;
 	width = 640;
 	height = 480;
 	current_line = -1;
 	title = NULL;
+	glyphs_cache = NULL;
 	for (int i = 0; i < SHADERNAME_SIZE; ++i) {
 		shaders[i] = NULL;
 	}
@@ -192,14 +255,35 @@ bool argus_is_init() {
 
 
 
+/// @brief Checks if a curve of the grid has an opened stream.
+/// @return true if a stream is opened.
+/// @note The streams refer to their curve and graph, so these mustn't be freed before the streams are closed.
+static bool argus_has_opened_stream() {
+	if (!grid) return false;
+	for (int i = 0; i < lines*columns; ++i) {
+		if (!grid[i]) continue;
+		for (size_t j = 0; j < grid[i]->curves->size; ++j) {
+			if (atomic_load(&grid[i]->curves->data[j]->stream_opened)) return true;
+		}
+	}
+	return false;
+}
+
 /// @brief Frees the memory used and quit the SDL.
 /// @note This must be called once you're done using this lib.
 void argus_quit() {
 	CHECK_INIT(init, argus_mutex);
+	if (argus_has_opened_stream()) {
+		fprintf(stderr, "[ARGUS]: warning: a curve has an opened stream. The library won't quit.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
 
 	// Frees the argus variables.
 	free(title);
 	title = NULL;
+	free(glyphs_cache);
+	glyphs_cache = NULL;
 	if (grid) {
 		for (int i = 0; i < lines*columns; ++i) graph_free(grid+i);
 		free(grid);
@@ -275,6 +359,7 @@ void argus_set_title(const char *window_title) {
 /// The window will contains m*n graphs rendered in a grid.
 /// @note If m or n is lower than 1, its value will be set to 1.
 /// @note A call to this function will destroys all previously created graphs.
+/// @note The grid isn't resized while a curve has an opened stream.
 void argus_set_grid_size(int w, int h) {
 	CHECK_INIT(init, argus_mutex)
 	if (w < 1) {
@@ -285,6 +370,11 @@ void argus_set_grid_size(int w, int h) {
 		fprintf(stderr, "[ARGUS]: warning: number of lines lower than 1. Will be set to 1.\n");
 		h = 1;
 	}
+	if (argus_has_opened_stream()) {
+		fprintf(stderr, "[ARGUS]: warning: a curve has an opened stream. The grid won't be resized.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
 
 	// Clears the old grid.
 	if (grid) {
@@ -375,6 +465,23 @@ void argus_set_screenshot_size(int width, int height) {
 	pthread_mutex_unlock(&argus_mutex);
 }
 
+/// @brief Defines the file where the glyphs atlas is cached between two runs.
+/// @param path The path of the cache file, or NULL to generate the atlas on each argus_show.
+/// @note The file is written by the first argus_show, and the next ones load the atlas from it
+/// instead of rendering the font.
+void argus_set_glyphs_cache(const char *path) {
+	CHECK_INIT(init, argus_mutex)
+	free(glyphs_cache);
+	glyphs_cache = NULL;
+	if (path && strlen(path)) {
+		glyphs_cache = malloc(strlen(path)+1);
+		if (glyphs_cache) strcpy(glyphs_cache, path);
+		else fprintf(stderr, "[ARGUS]: warning: unable to malloc a buffer for the glyphs cache path. "
+			"The atlas won't be cached!\n");
+	}
+	pthread_mutex_unlock(&argus_mutex);
+}
+
 /// @brief Sets the update frequency of the data.
 /// @param f The new frequency.
 /// @note This will sets the maximum amout of call to update_function per second.
@@ -420,6 +527,63 @@ void argus_set_update_timestep(float t) {
 	pthread_mutex_unlock(&argus_mutex);
 }
 
+/// @brief Sets the number of threads used to update the data.
+/// @param n The number of threads. 
+/// @note With more than one thread, the update functions of the curves are called in parallel
+/// on each update, so they must not share any unprotected state.
+/// @note The default is 1: all the curves are updated one after the other on the update thread.
+void argus_set_update_threads(int n) {
+	CHECK_INIT(init, argus_mutex)
+	if (n <= 0) {
+		fprintf(stderr, "[ARGUS]: warning: the number of update threads is lower "
+			"or equal to 0. It won't change.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	update_threads = n;
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Sets the maximal number of late updates run at once.
+/// @param n The number of updates.
+/// @note When the update thread falls behind the update frequency, the missed updates are run
+/// in a batch of at most n updates. The older ones are dropped, so a slow update function
+/// doesn't make the thread fall further and further behind.
+/// @note The default is 8. With 1, every late update is dropped.
+void argus_set_update_catchup(int n) {
+	CHECK_INIT(init, argus_mutex)
+	if (n <= 0) {
+		fprintf(stderr, "[ARGUS]: warning: the number of catch-up updates is lower "
+			"or equal to 0. It won't change.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	update_catchup = n;
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Enables or disables the fast-forward of the updates.
+/// @param enable true to run all the updates before showing the window.
+/// @note The duration/timestep updates of each curve are run at full speed, 
+/// in parallel when argus_set_update_threads allows it, and the window opens on the finished data.
+/// @note The update frequencies are then ignored.
+void argus_set_update_fast_forward(bool enable) {
+	CHECK_INIT(init, argus_mutex)
+	fast_forward = enable;
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Enables or disables the headless mode.
+/// @param enable true to save screenshots of the graphs instead of showing the window.
+/// @note In headless mode, argus_show renders the graphs on a hidden window, saves a screenshot 
+/// of each one into the screenshot path, named after its title, and returns.
+/// @note Combined with argus_set_update_fast_forward, the screenshots show the finished simulation.
+void argus_set_headless(bool enable) {
+	CHECK_INIT(init, argus_mutex)
+	headless = enable;
+	pthread_mutex_unlock(&argus_mutex);
+}
+
 /// @brief Sets the window render frequency.
 /// @param f The new timestep.
 /// @note f must be > 0.
@@ -564,7 +728,9 @@ void argus_graph_add_curve() {
 /// curve was the last one.
 void argus_graph_remove_curve() {
 	CHECK_INIT(init, argus_mutex)
-	if (current_curve >= 0) {
+	if (current_curve >= 0 && atomic_load(&CURRENT_CURVE->stream_opened)) {
+		fprintf(stderr, "[ARGUS]: warning: the current curve has an opened stream. It won't be removed.\n");
+	} else if (current_curve >= 0) {
 		curves_delete_curve(CURRENT_GRAPH->curves, current_curve);
 		if (curves_size(CURRENT_GRAPH->curves)) {
 			current_curve = current_curve ? current_curve - 1 : 0;
@@ -696,10 +862,88 @@ void argus_curve_set_color(Color color) {
 	pthread_mutex_unlock(&argus_mutex);
 }
 
+/// @brief Gets the curve streamed into by the argus_curve_add_* functions while the window is shown.
+/// @return The curve that was current when the window was shown, or NULL if it can't be streamed into.
+/// @note The selection functions wait for the end of argus_show, so the target can't change meanwhile.
+static Curve *argus_show_curve() {
+	if (!show_curve) {
+		fprintf(stderr, "[ARGUS]: warning: There was not any selected curve when the window was shown. "
+			"The data won't change.\n");
+		return NULL;
+	}
+	if (atomic_load(&show_curve->stream_opened)) {
+		fprintf(stderr, "[ARGUS]: warning: the selected curve has an opened stream. The data won't change.\n");
+		return NULL;
+	}
+	return show_curve;
+}
+
+/// @brief Streams x values into the curve that was current when the window was shown.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+/// @note The data is queued without taking the library mutex and added to the curve on the next frame,
+/// which the render loop is woken up for.
+/// @note The threads streaming this way wait for each other. Use an ArgusStream to stream without waiting.
+static void argus_curve_stream_x(const float *data, size_t n) {
+	pthread_mutex_lock(&stream_mutex);
+	Curve *curve = argus_show_curve();
+	if (curve) {
+		curve_stream_x_data_raw(curve, data, n);
+		wakeup_notify(&show_graph->dirty);
+	}
+	pthread_mutex_unlock(&stream_mutex);
+}
+
+/// @brief Streams y values into the curve that was current when the window was shown.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+/// @note The data is queued without taking the library mutex and added to the curve on the next frame,
+/// which the render loop is woken up for.
+/// @note The threads streaming this way wait for each other. Use an ArgusStream to stream without waiting.
+static void argus_curve_stream_y(const float *data, size_t n) {
+	pthread_mutex_lock(&stream_mutex);
+	Curve *curve = argus_show_curve();
+	if (curve) {
+		curve_stream_y_data_raw(curve, data, n);
+		wakeup_notify(&show_graph->dirty);
+	}
+	pthread_mutex_unlock(&stream_mutex);
+}
+
+/// @brief Streams interleaved points into the curve that was current when the window was shown.
+/// @param xy The coordinates of the points, as x0,y0,x1,y1,...
+/// @param n The number of points to add.
+/// @note The threads streaming this way wait for each other. Use an ArgusStream to stream without waiting.
+static void argus_curve_stream_xy(const float *xy, size_t n) {
+	pthread_mutex_lock(&stream_mutex);
+	Curve *curve = argus_show_curve();
+	if (curve) {
+		curve_stream_xy_interleaved_raw(curve, xy, n);
+		wakeup_notify(&show_graph->dirty);
+	}
+	pthread_mutex_unlock(&stream_mutex);
+}
+
+/// @brief Streams points into the curve that was current when the window was shown.
+/// @param x The x values of the points.
+/// @param y The y values of the points.
+/// @param n The number of points to add.
+/// @note The threads streaming this way wait for each other. Use an ArgusStream to stream without waiting.
+static void argus_curve_stream_xy_arrays(const float *x, const float *y, size_t n) {
+	pthread_mutex_lock(&stream_mutex);
+	Curve *curve = argus_show_curve();
+	if (curve) {
+		curve_stream_xy_data_raw(curve, x, y, n);
+		wakeup_notify(&show_graph->dirty);
+	}
+	pthread_mutex_unlock(&stream_mutex);
+}
+
 /// @brief Adds data to the x values of the current curve in the current graph.
 /// @param data The vector containing the data to add to the curve.
+/// @note While the window is shown, the data is streamed without the library mutex (see argus_curve_stream_x).
 void argus_curve_add_x(Vector *data) {
-	CHECK_INIT(init, argus_mutex)
+	CHECK_INIT_OR_STREAM(init, argus_mutex, argus_curve_stream_x(data->data, vector_size(data));)
 	if (current_curve < 0) {
 		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The x data won't change.\n");	
 		return;
@@ -710,8 +954,9 @@ void argus_curve_add_x(Vector *data) {
 
 /// @brief Adds data to the y values of the current curve in the current graph.
 /// @param data The vector containing the data to add to the curve.
+/// @note While the window is shown, the data is streamed without the library mutex (see argus_curve_stream_y).
 void argus_curve_add_y(Vector *data) {
-	CHECK_INIT(init, argus_mutex)
+	CHECK_INIT_OR_STREAM(init, argus_mutex, argus_curve_stream_y(data->data, vector_size(data));)
 	if (current_curve < 0) {
 		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The y data won't change.\n");	
 		return;
@@ -724,8 +969,9 @@ void argus_curve_add_y(Vector *data) {
 /// @param data The raw buffer containing the data.
 /// @param n The number of values to add.
 /// @note n must be lower or equal to the length of data.
+/// @note While the window is shown, the data is streamed without the library mutex (see argus_curve_stream_x).
 void argus_curve_add_x_raw(float *data, size_t n) {
-	CHECK_INIT(init, argus_mutex)
+	CHECK_INIT_OR_STREAM(init, argus_mutex, argus_curve_stream_x(data, n);)
 	if (current_curve < 0) {
 		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The x data won't change.\n");	
 		return;
@@ -738,8 +984,9 @@ void argus_curve_add_x_raw(float *data, size_t n) {
 /// @param data The raw buffer containing the data.
 /// @param n The number of values to add.
 /// @note n must be lower or equal to the length of data.
+/// @note While the window is shown, the data is streamed without the library mutex (see argus_curve_stream_y).
 void argus_curve_add_y_raw(float *data, size_t n) {
-	CHECK_INIT(init, argus_mutex)
+	CHECK_INIT_OR_STREAM(init, argus_mutex, argus_curve_stream_y(data, n);)
 	if (current_curve < 0) {
 		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The y data won't change.\n");	
 		return;
@@ -748,6 +995,158 @@ void argus_curve_add_y_raw(float *data, size_t n) {
 	pthread_mutex_unlock(&argus_mutex);
 }
 
+/// @brief Adds interleaved points to the current curve in the current graph.
+/// @param xy The coordinates of the points, as x0,y0,x1,y1,...
+/// @param n The number of points to add. xy must be 2*n values long.
+/// @note Both axes are updated under a single lock, so they can't get out of sync.
+/// @note While the window is shown, the points are streamed without the library mutex (see argus_curve_stream_xy).
+void argus_curve_add_xy_raw(const float *xy, size_t n) {
+	CHECK_INIT_OR_STREAM(init, argus_mutex, argus_curve_stream_xy(xy, n);)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The data won't change.\n");	
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	curve_push_xy_interleaved_raw(CURRENT_CURVE, xy, n);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Adds points to the current curve in the current graph.
+/// @param x The x values of the points.
+/// @param y The y values of the points.
+/// @param n The number of points to add. x and y must be n values long.
+/// @note Both axes are updated under a single lock, so they can't get out of sync.
+/// @note While the window is shown, the points are streamed without the library mutex (see argus_curve_stream_xy_arrays).
+void argus_curve_add_xy_arrays_raw(const float *x, const float *y, size_t n) {
+	CHECK_INIT_OR_STREAM(init, argus_mutex, argus_curve_stream_xy_arrays(x, y, n);)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The data won't change.\n");	
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	curve_push_xy_data_raw(CURRENT_CURVE, x, y, n);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Opens a stream into the current curve of the current graph, owned by the calling thread.
+/// @return The stream, or NULL in case of an error.
+/// @note A curve has at most one opened stream, and only the thread that opened it can use it,
+/// so several threads can stream into different curves while the window is shown.
+/// @note The stream must be opened before argus_show, and closed before the curve is removed,
+/// the grid resized or the library quit.
+ArgusStream *argus_curve_open_stream() {
+	CHECK_INIT(init, argus_mutex, NULL)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The stream won't be opened.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return NULL;
+	}
+	Curve *curve = CURRENT_CURVE;
+	if (atomic_exchange(&curve->stream_opened, true)) {
+		fprintf(stderr, "[ARGUS]: warning: the current curve already has an opened stream.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return NULL;
+	}
+	ArgusStream *stream = malloc(sizeof(ArgusStream));
+	if (!stream) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc an ArgusStream!\n");
+		atomic_store(&curve->stream_opened, false);
+		pthread_mutex_unlock(&argus_mutex);
+		return NULL;
+	}
+	*stream = (ArgusStream){curve, CURRENT_GRAPH, pthread_self()};
+	pthread_mutex_unlock(&argus_mutex);
+	return stream;
+}
+
+/// @brief Checks that a stream is used by the thread that opened it.
+/// @param stream The stream.
+/// @return false if the stream can't be used.
+static bool argus_stream_check(const ArgusStream *stream) {
+	if (!stream) {
+		fprintf(stderr, "[ARGUS]: warning: the stream isn't opened. The data won't change.\n");
+		return false;
+	}
+	if (!pthread_equal(stream->owner, pthread_self())) {
+		fprintf(stderr, "[ARGUS]: warning: a stream can only be used by the thread that opened it. "
+			"The data won't change.\n");
+		return false;
+	}
+	return true;
+}
+
+/// @brief Closes a stream.
+/// @param p_stream A pointer to the pointer of the stream to close. Cannot be NULL.
+/// @note After closing, the pointer *p_stream is set to NULL to avoid double-free.
+void argus_stream_close(ArgusStream **p_stream) {
+	ArgusStream *stream = *p_stream;
+	if (!stream || !argus_stream_check(stream)) return;
+	atomic_store(&stream->curve->stream_opened, false);
+	free(stream);
+	*p_stream = NULL;
+}
+
+/// @brief Adds data to the x values of the curve of a stream.
+/// @param stream The stream, used by the thread that opened it.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+/// @note While the window is shown, the data is queued without taking the library mutex.
+void argus_stream_add_x_raw(ArgusStream *stream, float *data, size_t n) {
+	if (!argus_stream_check(stream)) return;
+	CHECK_INIT_OR_STREAM(init, argus_mutex,
+		curve_stream_x_data_raw(stream->curve, data, n);
+		wakeup_notify(&stream->graph->dirty);
+	)
+	curve_push_x_data_raw(stream->curve, data, n);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Adds data to the y values of the curve of a stream.
+/// @param stream The stream, used by the thread that opened it.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+/// @note While the window is shown, the data is queued without taking the library mutex.
+void argus_stream_add_y_raw(ArgusStream *stream, float *data, size_t n) {
+	if (!argus_stream_check(stream)) return;
+	CHECK_INIT_OR_STREAM(init, argus_mutex,
+		curve_stream_y_data_raw(stream->curve, data, n);
+		wakeup_notify(&stream->graph->dirty);
+	)
+	curve_push_y_data_raw(stream->curve, data, n);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Adds interleaved points to the curve of a stream.
+/// @param stream The stream, used by the thread that opened it.
+/// @param xy The coordinates of the points, as x0,y0,x1,y1,...
+/// @param n The number of points to add. xy must be 2*n values long.
+/// @note While the window is shown, the points are queued without taking the library mutex.
+void argus_stream_add_xy_raw(ArgusStream *stream, const float *xy, size_t n) {
+	if (!argus_stream_check(stream)) return;
+	CHECK_INIT_OR_STREAM(init, argus_mutex,
+		curve_stream_xy_interleaved_raw(stream->curve, xy, n);
+		wakeup_notify(&stream->graph->dirty);
+	)
+	curve_push_xy_interleaved_raw(stream->curve, xy, n);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Adds points to the curve of a stream.
+/// @param stream The stream, used by the thread that opened it.
+/// @param x The x values of the points.
+/// @param y The y values of the points.
+/// @param n The number of points to add. x and y must be n values long.
+/// @note While the window is shown, the points are queued without taking the library mutex.
+void argus_stream_add_xy_arrays_raw(ArgusStream *stream, const float *x, const float *y, size_t n) {
+	if (!argus_stream_check(stream)) return;
+	CHECK_INIT_OR_STREAM(init, argus_mutex,
+		curve_stream_xy_data_raw(stream->curve, x, y, n);
+		wakeup_notify(&stream->graph->dirty);
+	)
+	curve_push_xy_data_raw(stream->curve, x, y, n);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
 /// @brief Sets the update function of the current curve.
 /// @param curve The curve that will be updated.
 /// @param func The function used for the update.
@@ -764,6 +1163,23 @@ void argus_curve_set_update_function(void (*func)(float *x, float *y, double dt)
 	pthread_mutex_unlock(&argus_mutex);
 }
 
+/// @brief Sets the batch update function of the current curve.
+/// @param func The function used for the update.
+/// @param n The maximal number of points produced by each update.
+/// @note func gets writable spans x and y of length len <= n and the timestep dt between two points,
+/// writes the next points into them and returns the number of points written.
+/// @note Each update of the data gives room for n new points, which are written directly into the curve buffers.
+void argus_curve_set_batch_update_function(size_t (*func)(float *x, float *y, size_t n, double dt), size_t n) {
+	CHECK_INIT(init, argus_mutex)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The update function won't change.\n");	
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	curve_set_batch_update_function(CURRENT_CURVE, func, n);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
 // Sets the current curve draw mode.
 void argus_curve_set_draw_mode(DrawMode mode) {
 	CHECK_INIT(init, argus_mutex)
@@ -775,7 +1191,95 @@ void argus_curve_set_draw_mode(DrawMode mode) {
 	pthread_mutex_unlock(&argus_mutex);
 }
 
+/// @brief Sets the update frequency of the current curve.
+/// @param f The number of updates per second of the curve.
+/// @note By default, the curve uses the frequency set by argus_set_update_frequency.
+/// @note Each curve is updated on its own deadlines, so a slow curve isn't updated at the rate of a fast one.
+void argus_curve_set_update_frequency(float f) {
+	CHECK_INIT(init, argus_mutex)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The update frequency won't change.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	if (f <= 0) {
+		fprintf(stderr, "[ARGUS]: warning: %f is not a valid update frequency. The update frequency won't change.\n", f);
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	CURRENT_CURVE->update_frequency = f;
+	pthread_mutex_unlock(&argus_mutex);
+}
 
+/// @brief Sets the update timestep of the current curve.
+/// @param t The timestep given to the update function of the curve.
+/// @note By default, the curve uses the timestep set by argus_set_update_timestep.
+/// @note The curve is updated on each instant t*k in [0,duration] for k in N.
+void argus_curve_set_update_timestep(float t) {
+	CHECK_INIT(init, argus_mutex)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The update timestep won't change.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	if (t <= 0) {
+		fprintf(stderr, "[ARGUS]: warning: %f is not a valid update timestep. The update timestep won't change.\n", t);
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	CURRENT_CURVE->update_timestep = t;
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Sets the size of the markers of the current curve in scatter mode.
+/// @param size The diameter of the markers in pixels.
+void argus_curve_set_marker_size(float size) {
+	CHECK_INIT(init, argus_mutex)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The marker size won't change.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	if (size <= 0) {
+		fprintf(stderr, "[ARGUS]: warning: %f is not a valid marker size. The marker size won't change.\n", size);
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	CURRENT_CURVE->marker_size = size;
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+/// @brief Enables or disables the min/max pyramid of the current curve.
+/// @param enable true to keep a pyramid of the y values of the curve.
+/// @note The pyramid makes the redraw of long curves with sorted x values depend 
+/// on the size of the graph rather than on the number of points. Useful for large recordings.
+void argus_curve_set_pyramid(bool enable) {
+	CHECK_INIT(init, argus_mutex)
+	if (current_curve < 0) {
+		fprintf(stderr, "[ARGUS]: warning: There is not any selected curve. The pyramid won't change.\n");
+		pthread_mutex_unlock(&argus_mutex);
+		return;
+	}
+	curve_set_pyramid(CURRENT_CURVE, enable);
+	pthread_mutex_unlock(&argus_mutex);
+}
+
+
+
+/// @brief Gets the latency of the last render showing new data.
+/// @return The time between the first notification of the data and the swap of the window, in seconds.
+/// @note It covers the data streamed while the window is shown and the data of the update functions.
+/// @note This can be called from any thread while the window is shown.
+double argus_get_render_latency() {
+	return atomic_load(&render_latency)*1e-9;
+}
+
+/// @brief Gets the maximal latency of the renders showing new data.
+/// @return The maximal time between a notification of data and the swap showing it since the window was shown, in seconds.
+/// @note This can be called from any thread while the window is shown.
+double argus_get_max_render_latency() {
+	return atomic_load(&max_render_latency)*1e-9;
+}
 
 
 
@@ -788,17 +1292,29 @@ void argus_curve_set_draw_mode(DrawMode mode) {
 void argus_show() {
 	CHECK_INIT(init, argus_mutex)
 
-	// Inits the iteration.
-	bool update = frequency > 0 && duration > 0 && timestep > 0;
-	max_iteration = update ? duration/timestep : 0;
+	// Inits the iteration. The curves can have their own frequency and timestep, so only the duration is needed.
+	bool update = duration > 0;
+	bool updating = false;
+	max_iteration = update && timestep > 0 ? duration/timestep : 0;
 	iteration = 0;
+
+	// Runs all the updates at once in fast-forward mode, so the window opens on the finished data.
+	if (update && fast_forward) {
+		if (!updater_fast_forward(grid, lines*columns, timestep, duration, update_threads)) {
+			fprintf(stderr, "[ARGUS]: error: unable to fast-forward the update of the data!\n");
+			pthread_mutex_unlock(&argus_mutex);
+			return;
+		}
+		iteration = updater_iteration();
+		update = false;
+	}
 	
 	// Creates the window.
 	window = SDL_CreateWindow(
 		title ? title : "ARGUS Window",
 		SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 
 		width, height,
-		SDL_WINDOW_OPENGL
+		SDL_WINDOW_OPENGL | (headless ? SDL_WINDOW_HIDDEN : 0)
 	);
 	if (!window) {
 		fprintf(stderr, "[ARGUS]: Error during window creation : %s.\n", SDL_GetError());
@@ -807,8 +1323,8 @@ void argus_show() {
 	}
 
 	// Sets the OpenGL attributes and creates the OpenGL context.
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 	context = SDL_GL_CreateContext(window);
@@ -828,6 +1344,10 @@ void argus_show() {
 		fprintf(stderr, "[ARGUS]: error: Failed to initialize GLEW.\n");
 		goto ARGUS_ERROR_CONTEXT_CREATION;
 	}
+	if (!shader_has_draw_id()) {
+		fprintf(stderr, "[ARGUS]: warning: GL_ARB_shader_draw_parameters isn't supported. "
+			"The curves of a graph will be drawn one by one.\n");
+	}
 
 	// Initializes the FBO for the screenshots.
 	if (!screenshot_fbo_create(1000,500)) {
@@ -851,7 +1371,7 @@ void argus_show() {
 	}
 
 	// Loads the glyphs set.
-	Glyphs *glyphs = glyphs_create(64);
+	Glyphs *glyphs = glyphs_create(64, glyphs_cache);
 	if (!glyphs) {
 		fprintf(stderr, "[ARGUS]: error: unable to load the glyphs set !\n");
 		goto ARGUS_ERROR_GLYPHS_CREATION;
@@ -859,6 +1379,7 @@ void argus_show() {
 
 	// Renders the window.
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	render_begin();
 	for (int i = 0; i < lines*columns; ++i) {
 		if (!graph_prepare_static(grid[i], glyphs, width, height) || 
 			!graph_prepare_dynamic(grid[i], glyphs, width, height)) {
@@ -867,99 +1388,146 @@ void argus_show() {
 		}
 		graph_render(grid[i], glyphs);
 	}
+	render_end();
 	SDL_GL_SwapWindow(window);
 
+	// Saves the screenshots of the graphs in headless mode, and leaves.
+	if (headless) {
+		char name[32];
+		for (int i = 0; i < lines*columns; ++i) {
+			const char *graph_title = grid[i]->title;
+			if (!graph_title || !strlen(graph_title)) {
+				snprintf(name, sizeof(name), "graph_%d", i);
+				graph_title = name;
+			}
+			if (!screenshot_graph(grid[i], glyphs, graph_title)) {
+				fprintf(stderr, "[ARGUS]: error: unable to save the screenshot of the graph %d!\n", i);
+			}
+		}
+		goto ARGUS_ERROR_GRAPHS_PREPARATION;
+	}
+
+	// Starts the update of the data on its own thread. It wakes the render loop up when there is new data.
+	if (!wakeup_init()) goto ARGUS_ERROR_GRAPHS_PREPARATION;
+	show_graph = CURRENT_GRAPH;
+	show_curve = current_curve >= 0 ? CURRENT_CURVE : NULL;
+	atomic_store(&showing, true);
+	if (update && !updater_start(grid, lines*columns, frequency, timestep, duration, update_threads, update_catchup)) {
+		fprintf(stderr, "[ARGUS]: error: unable to start the update of the data!\n");
+		goto ARGUS_ERROR_GRAPHS_PREPARATION;
+	}
+	updating = update;
+
 	// Window main loop.
 	bool run = true;
 	bool updated = false;
+	bool pending = false;
+	bool left_released = false;
+	uint64_t notified = 0;
 	int x = 0, y = 0;
+	atomic_store(&render_latency, 0);
+	atomic_store(&max_render_latency, 0);
+	const double render_period = 1000.0/render_frequency;
 	uint32_t last_loop_render = 0;
-	uint32_t last_loop_update = 0;
 	while (run) {
-		uint32_t time = SDL_GetTicks();
-
-		// Renders the content of the window if something has changed.
-		if (time-last_loop_render > 1000.0/render_frequency) {
-			last_loop_render = time;
-
-			// Catch the windows events.
-			SDL_Event event;
-			bool left_released = false;
-			while (SDL_PollEvent(&event)) {
-				switch (event.type) {
-				case SDL_QUIT: 
-					run = false; 
-					break;
-				case SDL_MOUSEBUTTONUP:
-					left_released = event.button.button == SDL_BUTTON_LEFT;
-					break;
-				}
-			}	
 
-			// Updates the save buttons.
-			SDL_GetMouseState(&x,&y);
-			const float xf = (float)x/width;
-			const float yf = (float)y/height;
-			for (size_t i = 0; i < (size_t)lines*columns; ++i) {
-				updated |= imagebutton_update(grid[i]->save, xf,yf, left_released);	
+		// Waits for an event. Something happened if pending is set, so it only waits until the next render.
+		// Otherwise it blocks until an event or a wake-up from the threads producing data.
+		SDL_Event event;
+		int received;
+		if (pending) {
+			const double wait = render_period - (SDL_GetTicks() - last_loop_render);
+			received = wait > 0 ? SDL_WaitEventTimeout(&event, (int)wait + 1) : SDL_PollEvent(&event);
+		} else received = SDL_WaitEvent(&event);
+
+		// Catch the windows events.
+		while (received) {
+			switch (event.type) {
+			case SDL_QUIT: 
+				run = false; 
+				break;
+			case SDL_MOUSEBUTTONUP:
+				left_released |= event.button.button == SDL_BUTTON_LEFT;
+				break;
 			}
 
-			// Renders the window to update the shown data.
-			if (updated) {
-				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-				for (size_t i = 0; i < (size_t)lines*columns; ++i) {
-					Graph *graph = grid[i];
-					if (!graph_prepare_dynamic(graph, glyphs, width, height)) {
-						fprintf(stderr, "[ARGUS]: error: Error during graph preparation !\n");
-						goto ARGUS_ERROR_GRAPHS_PREPARATION;
-					}
-					for (size_t j = 0; j < graph->curves->size; ++j) {
-						Curve *curve = graph->curves->data[j];
-						if (!curve->to_render) continue;
-
-						// Prepares the new curve VAO.
-						curve->to_render = false;
-						if (!curve_prepare_dynamic(curve, &graph->x_axis, &graph->y_axis, graph->grid_rect)) {
-							fprintf(stderr, "[ARGUS]: error: unable to create the vao of a curve!\n");
-							goto ARGUS_ERROR_GRAPHS_PREPARATION;
-						}
-					}
-
-					// Renders the graph.
-					graph_render(graph, glyphs);
-				}
-				SDL_GL_SwapWindow(window);
-				updated = false;
+			// Keeps the time of the oldest notification not shown yet.
+			if (wakeup_is(event.type)) {
+				const uint64_t time = wakeup_take();
+				if (!notified) notified = time;
+			}
+			pending = true;
+			received = SDL_PollEvent(&event);
+		}
+
+		// Renders the content of the window at most render_frequency times per second.
+		const uint32_t time = SDL_GetTicks();
+		if (!run || !pending || time-last_loop_render < render_period) continue;
+		last_loop_render = time;
+		pending = false;
+
+		// Updates the save buttons.
+		SDL_GetMouseState(&x,&y);
+		const float xf = (float)x/width;
+		const float yf = (float)y/height;
+		for (size_t i = 0; i < (size_t)lines*columns; ++i) {
+			updated |= imagebutton_update(grid[i]->save, xf,yf, left_released);	
+		}
+		left_released = false;
+
+		// Moves the data streamed by other threads and by the update thread into the curves.
+		// Only the graphs that were notified have new data.
+		for (size_t i = 0; i < (size_t)lines*columns; ++i) {
+			Graph *graph = grid[i];
+			if (!atomic_exchange_explicit(&graph->dirty, false, memory_order_acquire)) continue;
+			for (size_t j = 0; j < graph->curves->size; ++j) {
+				Curve *curve = graph->curves->data[j];
+				if (!curve_drain_streams(curve)) continue;
+				curve->to_render = true;
+				updated = true;
 			}
+		}
 
-		// Updates the data.
-		} else if (update && time-last_loop_update > 1000.0/frequency) {
-			last_loop_update = time;
-			bool graph_updated = false;
+		// Renders the window to update the shown data.
+		if (updated) {
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			render_begin();
 			for (size_t i = 0; i < (size_t)lines*columns; ++i) {
 				Graph *graph = grid[i];
-				if (!graph->curves->size) continue;
-				for (size_t j = 0; j < graph->curves->size; ++j) {
-					Curve *curve = graph->curves->data[j];
-					if (!curve->update) continue;
-					curve_update(curve, timestep);
-					curve->to_render = true;
-					graph_updated = true;
+
+				// Prepares only the components that changed, then records the draws of the graph.
+				if (!graph_prepare_dynamic(graph, glyphs, width, height)) {
+					fprintf(stderr, "[ARGUS]: error: Error during graph preparation !\n");
+					goto ARGUS_ERROR_GRAPHS_PREPARATION;
 				}
+				graph_render(graph, glyphs);
 			}
-			++iteration; 
-			update = iteration != max_iteration;
-			updated = graph_updated;
-
-		// Sleeps if there is nothing to do.
-		} else SDL_Delay(1);		
+			render_end();
+			SDL_GL_SwapWindow(window);
+			updated = false;
+
+			// Measures the latency from the notification of the data to its display.
+			if (notified) {
+				const uint64_t latency = (SDL_GetPerformanceCounter() - notified)*1e9/SDL_GetPerformanceFrequency();
+				atomic_store(&render_latency, latency);
+				if (latency > atomic_load(&max_render_latency)) atomic_store(&max_render_latency, latency);
+			}
+		}
+		notified = 0;
 	}
 
 	// Frees in case of an error or at the end of the function.
 ARGUS_ERROR_GRAPHS_PREPARATION:
+	updater_stop();
+	if (updating) iteration = updater_iteration();
+	atomic_store(&showing, false);
+	// Moves the data still queued into the curves, since the queues are only drained while showing.
 	for (int i = 0; i < lines*columns; ++i) {
+		for (size_t j = 0; j < grid[i]->curves->size; ++j) curve_drain_streams(grid[i]->curves->data[j]);
 		graph_reset_graphics(grid[i]);
 	}
+	render_free_commands();
+	vertexarena_free();
 	glyphs_free(&glyphs);
 ARGUS_ERROR_GLYPHS_CREATION:
 ARGUS_ERROR_SHADERS_CREATION:
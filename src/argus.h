@@ -8,6 +8,10 @@
 #include "enums.h"
 
 
+// Handle used by a single thread to stream data into a curve while the window is shown.
+typedef struct ArgusStream ArgusStream;
+
+
 
 ////////////////////////////////////////////////////////////////
 //                       Init functions                       //
@@ -45,6 +49,9 @@ void argus_set_screenshot_path(const char *path);
 // Defines the current screenshot size.
 void argus_set_screenshot_size(int width, int height);
 
+// Defines the file where the glyphs atlas is cached between two runs.
+void argus_set_glyphs_cache(const char *path);
+
 // Sets the update frequency of the data.
 void argus_set_update_frequency(float f);
 
@@ -54,6 +61,18 @@ void argus_set_update_duration(float d);
 // Sets the update timestep of the data.
 void argus_set_update_timestep(float t);
 
+// Sets the number of threads used to update the data.
+void argus_set_update_threads(int n);
+
+// Sets the maximal number of late updates run at once.
+void argus_set_update_catchup(int n);
+
+// Enables or disables the fast-forward of the updates.
+void argus_set_update_fast_forward(bool enable);
+
+// Enables or disables the headless mode.
+void argus_set_headless(bool enable);
+
 // Sets the window render frequency.
 void argus_set_render_frequency(float f);
 
@@ -127,6 +146,10 @@ void argus_curve_set_size(size_t size);
 // Sets the color of the current curve in the current graph.
 void argus_curve_set_color(Color color);
 
+// While the window is shown, the argus_curve_add_* functions don't take the library lock and 
+// add the data to the curve that was current when argus_show was called, one thread at a time.
+// To stream into several curves, or from several threads without waiting, use an ArgusStream per curve.
+
 // Adds data to the x values of the current curve in the current graph.
 void argus_curve_add_x(Vector *data);
 
@@ -139,12 +162,58 @@ void argus_curve_add_x_raw(float *data, size_t n);
 // Adds data to the y values of the current curve in the current graph.
 void argus_curve_add_y_raw(float *data, size_t n);
 
+// Adds interleaved points to the current curve in the current graph.
+void argus_curve_add_xy_raw(const float *xy, size_t n);
+
+// Adds points to the current curve in the current graph.
+void argus_curve_add_xy_arrays_raw(const float *x, const float *y, size_t n);
+
+// Opens a stream into the current curve of the current graph, owned by the calling thread.
+// It must be opened before argus_show, and closed before its curve is removed, the grid resized or the library quit.
+ArgusStream *argus_curve_open_stream();
+
+// Closes a stream.
+void argus_stream_close(ArgusStream **p_stream);
+
+// Adds data to the x values of the curve of a stream.
+void argus_stream_add_x_raw(ArgusStream *stream, float *data, size_t n);
+
+// Adds data to the y values of the curve of a stream.
+void argus_stream_add_y_raw(ArgusStream *stream, float *data, size_t n);
+
+// Adds interleaved points to the curve of a stream.
+void argus_stream_add_xy_raw(ArgusStream *stream, const float *xy, size_t n);
+
+// Adds points to the curve of a stream.
+void argus_stream_add_xy_arrays_raw(ArgusStream *stream, const float *x, const float *y, size_t n);
+
 // Sets the update function of the current curve.
 void argus_curve_set_update_function(void (*func)(float *x, float *y, double dt));
 
+// Sets the batch update function of the current curve.
+void argus_curve_set_batch_update_function(size_t (*func)(float *x, float *y, size_t n, double dt), size_t n);
+
+// Sets the update frequency of the current curve.
+void argus_curve_set_update_frequency(float f);
+
+// Sets the update timestep of the current curve.
+void argus_curve_set_update_timestep(float t);
+
 // Sets the current curve draw mode.
 void argus_curve_set_draw_mode(DrawMode mode);
 
+// Sets the size of the markers of the current curve in scatter mode.
+void argus_curve_set_marker_size(float size);
+
+// Enables or disables the min/max pyramid of the current curve.
+void argus_curve_set_pyramid(bool enable);
+
+// Gets the latency of the last render showing new data.
+double argus_get_render_latency();
+
+// Gets the maximal latency of the renders showing new data.
+double argus_get_max_render_latency();
+
 
 ////////////////////////////////////////////////////////////////
 //                    Rendering function                      //
@@ -8,83 +8,117 @@
 /// @brief Prepares the x axis title.
 /// @param axis The axis to prepare.
 /// @param glyphs The glyphs set to use.
+/// @param batch The batch where to add the characters of the title.
 /// @param p_rect The rect of the axis.
 /// @param window_width The window width.
 /// @param window_height The window height.
 /// @return false is there was an error.
-bool axis_prepare_x_title(Axis *axis, Glyphs *glyphs, Rect *p_rect, int window_width, int window_height) {
-	vao_free(&axis->axis_vao);
+bool axis_prepare_x_title(Axis *axis, Glyphs *glyphs, TextBatch *batch, Rect *p_rect, int window_width, int window_height) {
+	if (!axis->title || !strlen(axis->title)) return true;
 
-	// Constants used for the vertices generation.
+	// Constants used for the layout.
 	const float dx = 5.0f/window_width;
 	const Rect rect = *p_rect;
 
-	// Generates the vertices of the title.
-	int n = 0;
-	float *vertices = NULL;
-	float *textures = NULL;
-	if (axis->title && strlen(axis->title)) {
-		Rect text_rect = {rect.x+dx, rect.y, rect.w/2-2*dx, rect.h};
-		if (!glyphs_generate_vertical_text_buffers(glyphs, &text_rect, axis->title, 
-			(float)window_width/window_height, &vertices, &textures, &n)) {
-			fprintf(stderr, "[ARGUS]: error: unable to generate the buffers of data for the x axis title of a graph !\n");
-			return false;
-		}
+	// Adds the characters of the title.
+	Rect text_rect = {rect.x+dx, rect.y, rect.w/2-2*dx, rect.h};
+	if (!textbatch_add(batch, glyphs, text_rect, axis->title, (float)window_width/window_height, true, TEXTCOLOR_TEXT)) {
+		fprintf(stderr, "[ARGUS]: error: unable to generate the buffers of data for the x axis title of a graph !\n");
+		return false;
 	}
-
-	// Creates the VAO.
-	if (vertices && textures) {
-		axis->title_vao = glyphs_generate_text_vao(vertices, textures, n);
-		free(vertices);
-		free(textures);
-		if (!axis->title_vao) {
-			fprintf(stderr, "[ARGUS]: error: unable to creates the VAO for the x axis title of a graph !\n");
-			return false;
-		}
-	} else axis->title_vao = NULL;
 	return true;
 }
 
 /// @brief Prepares the y axis title.
 /// @param axis The axis to prepare.
 /// @param glyphs The glyphs set to use.
+/// @param batch The batch where to add the characters of the title.
 /// @param p_rect The rect of the axis.
 /// @param window_width The window width.
 /// @param window_height The window height.
 /// @return false is there was an error.
-bool axis_prepare_y_title(Axis *axis, Glyphs *glyphs, Rect *p_rect, int window_width, int window_height) {
-	vao_free(&axis->axis_vao);
+bool axis_prepare_y_title(Axis *axis, Glyphs *glyphs, TextBatch *batch, Rect *p_rect, int window_width, int window_height) {
+	if (!axis->title || !strlen(axis->title)) return true;
 
-	// Constants used for the vertices generation.
+	// Constants used for the layout.
 	const float dy = 5.0f/window_height;
 	const Rect rect = *p_rect;
 
-	// Generates the vertices of the title.
-	int n = 0;
-	float *vertices = NULL;
-	float *textures = NULL;
-	if (axis->title && strlen(axis->title)) {
-		Rect text_rect = {rect.x, rect.y+(rect.h-dy)/2+dy, rect.w, (rect.h+dy)/2-2*dy};
-		if (!glyphs_generate_text_buffers(glyphs, &text_rect, axis->title, 
-			(float)window_width/window_height, &vertices, &textures, &n)) {
-			fprintf(stderr, "[ARGUS]: error: unable to generate the buffers of data for the y axis title of a graph !\n");
-			return false;
-		}
+	// Adds the characters of the title.
+	Rect text_rect = {rect.x, rect.y+(rect.h-dy)/2+dy, rect.w, (rect.h+dy)/2-2*dy};
+	if (!textbatch_add(batch, glyphs, text_rect, axis->title, (float)window_width/window_height, false, TEXTCOLOR_TEXT)) {
+		fprintf(stderr, "[ARGUS]: error: unable to generate the buffers of data for the y axis title of a graph !\n");
+		return false;
 	}
+	return true;
+}
 
-	// Creates the VAO.
-	if (vertices && textures) {
-		axis->title_vao = glyphs_generate_text_vao(vertices, textures, n);
-		free(vertices);
-		free(textures);
-		if (!axis->title_vao) {
-			fprintf(stderr, "[ARGUS]: error: unable to creates the VAO for the y axis title of a graph !\n");
+/// @brief Checks if the labels of an axis were prepared for the same ticks and the same layout.
+/// @param axis The axis to check.
+/// @param grid_rect The rect of the grid.
+/// @param range The range of values (max-min).
+/// @param offset The offset of the grid.
+/// @param base The first number to render.
+/// @param d The delta between each value to render.
+/// @param n The number of values to render.
+/// @param window_ratio The ratio of the window (w/h).
+/// @return true if the labels can be kept as they are.
+static bool axis_labels_match(const Axis *axis, const Rect *grid_rect, float range, float offset, 
+float base, float d, int n, float window_ratio) {
+	const AxisLabels *labels = &axis->labels;
+	return labels->glyphs && labels->n == n && labels->base == base && labels->d == d && 
+		labels->range == range && labels->offset == offset && labels->window_ratio == window_ratio &&
+		labels->grid_rect.x == grid_rect->x && labels->grid_rect.y == grid_rect->y && 
+		labels->grid_rect.w == grid_rect->w && labels->grid_rect.h == grid_rect->h;
+}
+
+/// @brief Formats the texts of the labels of an axis, unless the values didn't change.
+/// @param labels The labels to format.
+/// @param base The first number to render.
+/// @param d The delta between each value to render.
+/// @param n The number of values to render.
+/// @param format The printf format of the values.
+/// @return false if there was an error.
+/// @note The buffers of the labels only grow, so the same ticks never cause an allocation.
+static bool axis_labels_format(AxisLabels *labels, float base, float d, int n, const char *format) {
+	if (!labels->glyphs) labels->glyphs = textbatch_create();
+	if (!labels->glyphs) return false;
+	if (labels->texts && labels->n == n && labels->base == base && labels->d == d) return true;
+
+	// Grows the buffer if needed.
+	if (n > labels->cap) {
+		void *texts = realloc(labels->texts, n*sizeof(*labels->texts));
+		if (!texts) {
+			fprintf(stderr, "[ARGUS]: error: unable to realloc the buffer of the labels of an axis !\n");
 			return false;
 		}
-	} else axis->title_vao = NULL;
+		labels->texts = texts;
+		labels->cap = n;
+	}
+
+	// Formats the values.
+	for (int i = 0; i < n; ++i) {
+		snprintf(labels->texts[i], sizeof(*labels->texts), format, base + i*d);
+	}
+	labels->n = n;
+	labels->base = base;
+	labels->d = d;
 	return true;
 }
 
+/// @brief Saves the layout the labels of an axis were prepared for.
+/// @param labels The labels that were prepared.
+/// @param grid_rect The rect of the grid.
+/// @param range The range of values (max-min).
+/// @param offset The offset of the grid.
+/// @param window_ratio The ratio of the window (w/h).
+static void axis_labels_save(AxisLabels *labels, const Rect *grid_rect, float range, float offset, float window_ratio) {
+	labels->grid_rect = *grid_rect;
+	labels->range = range;
+	labels->offset = offset;
+	labels->window_ratio = window_ratio;
+}
+
 /// @brief Prepares the x axis graduation depending of the min and max values.
 /// @param axis The axis to prepare.
 /// @param glyphs The glyph set to use.
@@ -97,76 +131,58 @@ bool axis_prepare_y_title(Axis *axis, Glyphs *glyphs, Rect *p_rect, int window_w
 /// @param window_width The window width.
 /// @param window_height The window height.
 /// @return false if there was an error.
+/// @note Nothing is done if the ticks and the layout didn't change. If only the layout changed,
+/// the labels are placed again from the cached glyph layouts, without formatting them again.
 bool axis_prepare_x_axis(Axis *axis, Glyphs *glyphs, Rect *p_grid_rect, float range, float offset, 
 float base, float d, int n, int window_width, int window_height) {
-	vao_free(&axis->axis_vao);
 
-	// Constants used for the vertices generation.
+	// Constants used for the layout.
 	const float window_ratio = (float)window_width/window_height;
 	const float dy = 5.0f/window_height;
 	const Rect grid_rect = *p_grid_rect;
+	AxisLabels *labels = &axis->labels;
 
-	// Malloc the buffers to store the vertices.
-	float *vertices = malloc(192*n*sizeof(float));
-	float *textures = malloc(192*n*sizeof(float));
-	if (!vertices || !textures) {
-		fprintf(stderr, "[ARGUS]: error: unable to malloc buffers for the data of the x axis of a graph !\n");
+	// Formats the numbers if the ticks changed.
+	if (axis_labels_match(axis, &grid_rect, range, offset, base, d, n, window_ratio)) return true;
+	if (!axis_labels_format(labels, base, d, n, "%.g")) {
+		fprintf(stderr, "[ARGUS]: error: unable to format the labels of the x axis of a graph !\n");
 		return false;
 	}
 	
-	// Generates the vertices of each numbers and adds it to vertices and textures.
-	int size = 0;
+	// Places the layout of each number and adds its characters to the labels.
+	textbatch_clear(labels->glyphs);
+	labels->window_ratio = 0.0f;
 	for (int i = 0; i < n; ++i) {
-		float value = base + i*d;
-		char text_buffer[16];
-		snprintf(text_buffer, sizeof(text_buffer), "%.g", value); 
 
-		// Calculates the number to render and converts it to a string.
+		// Calculates the rect to render the text.
 		Rect rect = {
 			offset + (i*grid_rect.w-0.25)*d/range, grid_rect.y+grid_rect.h+dy,
 			0.5*d/range, 4*dy
 		};
 
-		// Gets the vertices buffers of the number to render.
-		int n = 0;
-		float *v = NULL, *t = NULL;		
-		if (!glyphs_generate_text_buffers(glyphs, &rect, text_buffer, window_ratio, &v, &t, &n)) {
+		// Gets the layout of the number to render.
+		const GlyphsLayout *layout = glyphs_layout(glyphs, rect.w, rect.h, labels->texts[i], window_ratio, false);
+		if (!layout) {
 			fprintf(stderr, "[ARGUS]: error: unable to generate the buffers of data for the x axis of a graph !\n");
-			free(v);
-			free(t);
-			free(vertices);
-			free(textures);
 			return false;
 		}
+		const int n = layout->n;
+		const float *r = layout->rects;
+		if (!n) continue;
 
 		// Calculates offsets when needed.
-		float x_max = grid_rect.x+grid_rect.w-v[12*n-2];
+		float x_max = grid_rect.x+grid_rect.w-(rect.x+r[4*n-4]+r[4*n-2]);
 		if (x_max > 0) x_max = 0;
-		float x_min = grid_rect.x-v[6];
+		float x_min = grid_rect.x-(rect.x+r[0]);
 		if (x_min < 0) x_min = 0;
 
-		// Gets the vertices buffers of the number to render.
-		for (int i = 0; i < 6*n; ++i) {
-			vertices[12*(size)+2*i]		= v[2*i]+x_max+x_min;
-			vertices[12*(size)+2*i+1]	= v[2*i+1];
-			textures[12*(size)+2*i]		= t[2*i];
-			textures[12*(size)+2*i+1]	= t[2*i+1];
+		// Moves the characters of the number to their place.
+		if (!textbatch_add_layout(labels->glyphs, layout, rect.x+x_max+x_min, rect.y, TEXTCOLOR_TEXT)) {
+			fprintf(stderr, "[ARGUS]: error: unable to add the labels of the x axis of a graph !\n");
+			return false;
 		}
-
-		// Frees the buffers and update the size of the VAO.
-		size += n;
-		free(v);
-		free(t);
-	}
-	
-	// Creates the VAO.
-	axis->axis_vao = glyphs_generate_text_vao(vertices, textures, size);
-	free(vertices);
-	free(textures);
-	if (!axis->axis_vao) {
-		fprintf(stderr, "[ARGUS]: error: unable to generate the VAO for the x axis of a graph !\n");
-		return false;
 	}
+	axis_labels_save(labels, &grid_rect, range, offset, window_ratio);
 	return true;
 }
 
@@ -182,84 +198,65 @@ float base, float d, int n, int window_width, int window_height) {
 /// @param window_width The window width.
 /// @param window_height The window height.
 /// @return false if there was an error.
+/// @note Nothing is done if the ticks and the layout didn't change. If only the layout changed,
+/// the labels are placed again from the cached glyph layouts, without formatting them again.
 bool axis_prepare_y_axis(Axis *axis, Glyphs *glyphs, Rect *p_grid_rect, float range, float offset, 
 float base, float d, int n, int window_width, int window_height) {
-	vao_free(&axis->axis_vao);
 	
-	// Constants used for the vertices generation.
+	// Constants used for the layout.
 	const float window_ratio = (float)window_width/window_height;
 	const float dx = 5.0f/window_width;
 	const Rect grid_rect = *p_grid_rect;
+	AxisLabels *labels = &axis->labels;
 
-	// Malloc the buffers to store the vertices.
-	float *vertices = malloc(192*n*sizeof(float));
-	float *textures = malloc(192*n*sizeof(float));
-	if (!vertices || !textures) {
-		fprintf(stderr, "[ARGUS]: error: unable to malloc buffers for the data of the y axis of a graph !\n");
+	// Formats the numbers if the ticks changed.
+	if (axis_labels_match(axis, &grid_rect, range, offset, base, d, n, window_ratio)) return true;
+	if (!axis_labels_format(labels, base, d, n, "%.3g")) {
+		fprintf(stderr, "[ARGUS]: error: unable to format the labels of the y axis of a graph !\n");
 		return false;
 	}
 
-	// Generates the vertices of each numbers and adds it to vertices and textures.
-	int size = 0;
+	// Places the layout of each number and adds its characters to the labels.
+	textbatch_clear(labels->glyphs);
+	labels->window_ratio = 0.0f;
 	for (int i = 0; i < n; ++i) {
 
-		// Calculates the number to render and converts it to a string.
-		float value = base + i*d;
-		char text_buffer[16];
-		snprintf(text_buffer, sizeof(text_buffer), "%.3g", value); 
-
 		// Calculates the rect to render the text.
 		Rect rect = {
 			grid_rect.x-5*dx, grid_rect.y + grid_rect.h - (offset + (i*grid_rect.h+0.25)*d/range),
 			4*dx, 0.5*d/range
 		};
 		
-		// Gets the vertices buffers of the number to render.
-		int n = 0;
-		float *v = NULL, *t = NULL;
-		if (!glyphs_generate_vertical_text_buffers(glyphs, &rect, text_buffer, window_ratio, &v, &t, &n)) {
+		// Gets the layout of the number to render.
+		const GlyphsLayout *layout = glyphs_layout(glyphs, rect.w, rect.h, labels->texts[i], window_ratio, true);
+		if (!layout) {
 			fprintf(stderr, "[ARGUS]: error: unable to generate the buffers of data for the y axis of a graph !\n");
-			free(v);
-			free(t);
-			free(vertices);
-			free(textures);
 			return false;
 		}
+		const int n = layout->n;
+		const float *r = layout->rects;
+		if (!n) continue;
 
 		// Calculates offsets when needed.
-		float y_max = grid_rect.y-v[12*n-1];
+		float y_max = grid_rect.y-(rect.y+r[4*n-3]);
 		if (y_max < 0) y_max = 0;
-		float y_min = grid_rect.y+grid_rect.h-v[1];
+		float y_min = grid_rect.y+grid_rect.h-(rect.y+r[1]+r[3]);
 		if (y_min > 0) y_min = 0;
 
-		// Copy the vertices and adds an offset when needed.
-		for (int i = 0; i < 6*n; ++i) {
-			vertices[12*(size)+2*i]		= v[2*i];
-			vertices[12*(size)+2*i+1]	= v[2*i+1]+y_max+y_min;
-			textures[12*(size)+2*i]		= t[2*i];
-			textures[12*(size)+2*i+1]	= t[2*i+1];
+		// Moves the characters of the number to their place.
+		if (!textbatch_add_layout(labels->glyphs, layout, rect.x, rect.y+y_max+y_min, TEXTCOLOR_TEXT)) {
+			fprintf(stderr, "[ARGUS]: error: unable to add the labels of the y axis of a graph !\n");
+			return false;
 		}
-
-		// Frees the buffers and pasupdate the size of the VAO.
-		size += n;
-		free(v);
-		free(t);
-	}
-	
-	// Creates the VAO.
-	axis->axis_vao = glyphs_generate_text_vao(vertices, textures, size);
-	free(vertices);
-	free(textures);
-	if (!axis->axis_vao) {
-		fprintf(stderr, "[ARGUS]: error: unable to generate the VAO for the x axis of a graph !\n");
-		return false;
 	}
+	axis_labels_save(labels, &grid_rect, range, offset, window_ratio);
 	return true;
 }
 
 /// @brief Reset the graphical components of an axis after the rendering process.
 /// @param axis The axis to reset.
 void axis_reset_graphics(Axis *axis) {
-	vao_free(&axis->title_vao);
-	vao_free(&axis->axis_vao);
+	free(axis->labels.texts);
+	textbatch_free(&axis->labels.glyphs);
+	axis->labels = (AxisLabels){0};
 }
@@ -4,29 +4,43 @@
 
 #include "glyphs.h"
 #include "structs.h"
-#include "vao.h"
+#include "text_batch.h"
 
 
+/// @struct AxisLabels
+/// @brief The graduation labels of an axis, kept between two preparations.
+typedef struct {
+	char (*texts)[GLYPHS_LAYOUT_TEXT];	///< The text of each label.
+	TextBatch *glyphs;	///< The characters of the labels.
+	int cap;			///< The number of labels the buffers can hold.
+	int n;				///< The number of labels of the texts.
+	float base;			///< The first value of the texts.
+	float d;			///< The delta between the values of the texts.
+	float range;		///< The range of values the labels were prepared for.
+	float offset;		///< The offset of the grid the labels were prepared for.
+	Rect grid_rect;		///< The rect of the grid the labels were prepared for.
+	float window_ratio;	///< The ratio of the window the labels were prepared for.
+} AxisLabels;
+
 /// @struct Axis
 /// @brief Used to create an axis (x or y) for a graph.
 typedef struct {
-	VAO *axis_vao;		///< VAO to render the graduations.
-	VAO *title_vao;		///< VAO to render the title.
 	char *title;		///< Title of the axis.
 	float min;			///< Min value of the axis.
 	float max;			///< Max value of the axis.
 	AxisAdaptMode auto_adapt;	///< The adapt mode to use.
+	AxisLabels labels;	///< The graduation labels, reused while the ticks don't change.
 } Axis;
 
 // Default axis value.
-#define AXIS_INIT (Axis){NULL, NULL, NULL, 0.0f, 1.0f, true}
+#define AXIS_INIT (Axis){NULL, 0.0f, 1.0f, true, {0}}
 
 
 // Prepares the x axis title.
-bool axis_prepare_x_title(Axis *axis, Glyphs *glyphs, Rect *p_rect, int window_width, int window_height);
+bool axis_prepare_x_title(Axis *axis, Glyphs *glyphs, TextBatch *batch, Rect *p_rect, int window_width, int window_height);
 
 // Prepares the y axis title.
-bool axis_prepare_y_title(Axis *axis, Glyphs *glyphs, Rect *p_rect, int window_width, int window_height);
+bool axis_prepare_y_title(Axis *axis, Glyphs *glyphs, TextBatch *batch, Rect *p_rect, int window_width, int window_height);
 
 // Prepares the x axis graduation depending of the min and max values.
 bool axis_prepare_x_axis(Axis *axis, Glyphs *glyphs, Rect *p_grid_rect, float range, float offset, 
@@ -5,7 +5,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <float.h>
-#include "point.h"
+#include "decimate.h"
 
 
 
@@ -18,15 +18,44 @@ Curve *curve_create() {
 		return NULL;
 	}
 	curve->color = COLOR_BLACK;
-	curve->curve_vao = NULL;
+	curve->curve_block = ARENABLOCK_INIT;
 	curve->x_min = FLT_MAX;
-	curve->x_max = FLT_MIN;
+	curve->x_max = -FLT_MAX;
 	curve->y_min = FLT_MAX;
-	curve->y_max = FLT_MIN;
+	curve->y_max = -FLT_MAX;
 	curve->x_val = NULL;
 	curve->y_val = NULL;
+	curve->x_queue = NULL;
+	curve->y_queue = NULL;
+	atomic_init(&curve->stream_opened, false);
+	curve->x_window = NULL;
+	curve->y_window = NULL;
+	curve->x_update_queue = NULL;
+	curve->y_update_queue = NULL;
+	curve->update_x = 0.0f;
+	curve->update_y = 0.0f;
 	curve->to_render = false;
+	curve->x_pending = 0;
+	curve->y_pending = 0;
+	curve->gpu_valid = false;
+	curve->scatter_valid = false;
+	curve->x_count = 0;
+	curve->x_descent = 0;
+	curve->x_last = 0.0f;
+	curve->scatter_vao = NULL;
+	curve->marker_size = 5.0f;
+	curve->use_pyramid = false;
+	curve->y_pyramid = NULL;
+	curve->m4_block = ARENABLOCK_INIT;
+	curve->m4_data = NULL;
+	curve->m4_cap = 0;
+	curve->decimated = false;
+	curve->ranges = 0;
 	curve->update = NULL;
+	curve->batch_update = NULL;
+	curve->batch_size = 0;
+	curve->update_frequency = 0.0f;
+	curve->update_timestep = 0.0f;
 	curve->mode = DRAW_CURVE;
 	return curve;
 }
@@ -37,9 +66,19 @@ Curve *curve_create() {
 void curve_free(Curve **p_curve) {
 	Curve *curve = *p_curve;
 	if (!curve) return;
-	vao_free(&curve->curve_vao);
+	vertexarena_release(&curve->curve_block);
+	vertexarena_release(&curve->m4_block);
+	vao_free_instanced(&curve->scatter_vao);
+	free(curve->m4_data);
 	ringbuffer_free(&curve->x_val);
 	ringbuffer_free(&curve->y_val);
+	spscqueue_free(&curve->x_queue);
+	spscqueue_free(&curve->y_queue);
+	spscqueue_free(&curve->x_update_queue);
+	spscqueue_free(&curve->y_update_queue);
+	minmaxwindow_free(&curve->x_window);
+	minmaxwindow_free(&curve->y_window);
+	pyramid_free(&curve->y_pyramid);
 	free(curve);
 	*p_curve = NULL;
 }
@@ -49,11 +88,110 @@ void curve_free(Curve **p_curve) {
 /// @param curve Pointer to the curve whose buffers will be resized.
 /// @param cap New capacity for the x and y data buffers.
 /// @note This function frees the existing buffers and allocates new ones with the specified capacity.
+/// @note The stream queues are resized too, so that a full buffer can be streamed between two frames.
+/// @note From RINGBUFFER_MIRROR_MIN values, the buffers are mirrored and their capacity 
+/// is rounded up to a multiple of the page size.
 void curve_set_data_cap(Curve *curve, size_t cap) {
 	ringbuffer_free(&curve->x_val);
 	ringbuffer_free(&curve->y_val);
-	curve->x_val = ringbuffer_create(cap);
-	curve->y_val = ringbuffer_create(cap);
+	spscqueue_free(&curve->x_queue);
+	spscqueue_free(&curve->y_queue);
+	spscqueue_free(&curve->x_update_queue);
+	spscqueue_free(&curve->y_update_queue);
+	if (cap >= RINGBUFFER_MIRROR_MIN) {
+		curve->x_val = ringbuffer_create_mirrored(cap);
+		curve->y_val = ringbuffer_create_mirrored(cap);
+		if (curve->x_val && curve->y_val && curve->x_val->cap != curve->y_val->cap) {
+			ringbuffer_free(&curve->x_val);
+			ringbuffer_free(&curve->y_val);
+		}
+	}
+	if (!curve->x_val || !curve->y_val) {
+		ringbuffer_free(&curve->x_val);
+		ringbuffer_free(&curve->y_val);
+		curve->x_val = ringbuffer_create(cap);
+		curve->y_val = ringbuffer_create(cap);
+	}
+	if (curve->x_val) cap = curve->x_val->cap;
+	curve->x_queue = spscqueue_create(cap);
+	curve->y_queue = spscqueue_create(cap);
+	curve->x_update_queue = spscqueue_create(cap);
+	curve->y_update_queue = spscqueue_create(cap);
+	minmaxwindow_free(&curve->x_window);
+	minmaxwindow_free(&curve->y_window);
+	curve->x_window = minmaxwindow_create(cap);
+	curve->y_window = minmaxwindow_create(cap);
+	curve->x_min = FLT_MAX;
+	curve->x_max = -FLT_MAX;
+	curve->y_min = FLT_MAX;
+	curve->y_max = -FLT_MAX;
+	pyramid_free(&curve->y_pyramid);
+	if (curve->use_pyramid) curve->y_pyramid = pyramid_create(cap);
+	curve->gpu_valid = false;
+	curve->scatter_valid = false;
+	curve->x_count = 0;
+	curve->x_descent = 0;
+}
+
+/// @brief Updates the x-axis limits and order tracking with values added to the x-axis buffer.
+/// @note The limits are the extrema of the values still in the buffer.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param data The values added to the buffer.
+/// @param n The number of values added.
+static void curve_track_x(Curve *curve, const float *data, size_t n) {
+	curve->x_pending += n;
+	for (size_t i = 0; i < n; ++i) {
+		const float val = data[i];
+		if (curve->x_count && val < curve->x_last) curve->x_descent = curve->x_count;
+		curve->x_last = val;
+		++curve->x_count;
+	}
+	minmaxwindow_push(curve->x_window, data, n);
+	curve->x_min = minmaxwindow_min(curve->x_window);
+	curve->x_max = minmaxwindow_max(curve->x_window);
+}
+
+/// @brief Pushes values into the x-axis buffer and updates the x-axis limits.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+static void curve_push_x(Curve *curve, const float *data, size_t n) {
+	ringbuffer_push_back_n(curve->x_val, data, n);
+	curve_track_x(curve, data, n);
+}
+
+/// @brief Checks if the x-axis values in the buffer of a curve are sorted.
+/// @param curve The curve to check.
+/// @return true if the x-axis values are sorted in increasing order.
+/// @note The last decreasing value may have been erased from the buffer since it was pushed.
+static bool curve_x_sorted(const Curve *curve) {
+	return curve->x_descent < curve->x_count - curve->x_val->size + 1;
+}
+
+/// @brief Updates the y-axis limits and pyramid with values about to be added to the y-axis buffer.
+/// @note The limits are the extrema of the values still in the buffer.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param data The values added to the buffer.
+/// @param n The number of values added.
+/// @note Must be called before the values are committed to the buffer, to mark the right pyramid slots.
+static void curve_track_y(Curve *curve, const float *data, size_t n) {
+	curve->y_pending += n;
+	if (curve->y_pyramid) {
+		const RingBuffer *y = curve->y_val;
+		pyramid_mark(curve->y_pyramid, y->start + y->size, n);
+	}
+	minmaxwindow_push(curve->y_window, data, n);
+	curve->y_min = minmaxwindow_min(curve->y_window);
+	curve->y_max = minmaxwindow_max(curve->y_window);
+}
+
+/// @brief Pushes values into the y-axis buffer and updates the y-axis limits.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+static void curve_push_y(Curve *curve, const float *data, size_t n) {
+	curve_track_y(curve, data, n);
+	ringbuffer_push_back_n(curve->y_val, data, n);
 }
 
 /// @brief Pushes new x-axis data into the curve's buffer.
@@ -65,12 +203,7 @@ void curve_push_x_data(Curve *curve, Vector *data) {
 		fprintf(stderr, "[ARGUS]: warning: the space left in the buffer of the x axis of a graph "
 			"is lower than the amount of data that will be pushed. The oldset data will be erased.\n");
 	}
-	for (size_t i = 0; i < n; ++i) {
-		const float val = data->data[i];
-		ringbuffer_push_back(curve->x_val, val);
-		if (val < curve->x_min) curve->x_min = val;
-		if (val > curve->x_max) curve->x_max = val;
-	}
+	curve_push_x(curve, data->data, n);
 }
 
 /// @brief Pushes new y-axis data into the curve's buffer.
@@ -82,12 +215,7 @@ void curve_push_y_data(Curve *curve, Vector *data) {
 		fprintf(stderr, "[ARGUS]: warning: the space left in the buffer of the y axis of a graph "
 			"is lower than the amount of data that will be pushed. The oldset data will be erased.\n");
 	}
-	for (size_t i = 0; i < n; ++i) {
-		const float val = data->data[i];
-		ringbuffer_push_back(curve->y_val, val);
-		if (val < curve->y_min) curve->y_min = val;
-		if (val > curve->y_max) curve->y_max = val;
-	}
+	curve_push_y(curve, data->data, n);
 }
 
 /// @brief Pushes new x-axis data into the curve's buffer.
@@ -100,12 +228,7 @@ void curve_push_x_data_raw(Curve *curve, float *data, size_t n) {
 		fprintf(stderr, "[ARGUS]: warning: the space left in the buffer of the x axis of a graph "
 			"is lower than the amount of data that will be pushed. The oldset data will be erased.\n");
 	}
-	for (size_t i = 0; i < n; ++i) {
-		const float val = data[i];
-		ringbuffer_push_back(curve->x_val, val);
-		if (val < curve->x_min) curve->x_min = val;
-		if (val > curve->x_max) curve->x_max = val;
-	}
+	curve_push_x(curve, data, n);
 }
 
 /// @brief Pushes new y-axis data into the curve's buffer.
@@ -118,205 +241,394 @@ void curve_push_y_data_raw(Curve *curve, float *data, size_t n) {
 		fprintf(stderr, "[ARGUS]: warning: the space left in the buffer of the y axis of a graph "
 			"is lower than the amount of data that will be pushed. The oldset data will be erased.\n");
 	}
-	for (size_t i = 0; i < n; ++i) {
-		const float val = data[i];
-		ringbuffer_push_back(curve->y_val, val);
-		if (val < curve->y_min) curve->y_min = val;
-		if (val > curve->y_max) curve->y_max = val;
-	}
+	curve_push_y(curve, data, n);
 }
 
+/// @brief Pushes new points into the curve's buffers.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param x The x-axis values of the points.
+/// @param y The y-axis values of the points.
+/// @param n The number of points to add.
+/// @note Both buffers are updated together, so they can't get out of sync.
+void curve_push_xy_data_raw(Curve *curve, const float *x, const float *y, size_t n) {
+	if (n + curve->x_val->size > curve->x_val->cap) {
+		fprintf(stderr, "[ARGUS]: warning: the space left in the buffers of a graph "
+			"is lower than the amount of data that will be pushed. The oldset data will be erased.\n");
+	}
+	curve_push_x(curve, x, n);
+	curve_push_y(curve, y, n);
+}
 
-
-
-
-
-
-
-
-
-
-
-/// @brief Generates the vertices for a curve.
-/// @param x The x coordinates data to use.
-/// @param y The y coordinates data to use.
-/// @param vertices The vector where to store the vertices.
-/// @param limits The axis limits.
-/// @param rect The rect of the graph.
-void curve_prepare_curve(RingBuffer *x, RingBuffer *y, Vector *vertices, const Rect limits, const Rect rect) {
-	const size_t size = x->size;
-	if (size < 2) return;
-	const float x_min = limits.x;
-	const float y_min = limits.y;
-	const float x_max = limits.w;
-	const float y_max = limits.h;
-
-	// Adds all the points of the curve if they're visible.
-	bool curve_started = false;
-	size_t i = 0;
-	Point prev, current;
-	prev.x = (ringbuffer_at(x, 0)-x_min) / (x_max-x_min);
-	prev.y = 1.0f-(ringbuffer_at(y, 0)-y_min) / (y_max-y_min);
-	while (i < size) {
-
-		// Gets the current point coordinates and checks what should be added to the point vector.
-		current.x = (ringbuffer_at(x, i)-x_min) / (x_max-x_min);
-		current.y = 1.0f-(ringbuffer_at(y, i)-y_min) / (y_max-y_min);
-		if (curve_started) {
-
-			// Both points are in the graph area.
-			if (current.x >= 0 && current.x <= 1 && current.y >= 0 && current.y <= 1) {
-				vector_push_back(vertices, rect.x + rect.w*current.x);
-				vector_push_back(vertices, rect.y + rect.h*current.y);
-
-			// The first point is in the graph area but not the second.
-			} else {
-				Point new_current;
-				move_in_rectangle(prev, current, &new_current);
-				vector_push_back(vertices, rect.x + rect.w*new_current.x);
-				vector_push_back(vertices, rect.y + rect.h*new_current.y);
-				curve_started = false;
-			}
-
-		} else {
-
-			// The second point is in the graph area but not the first.
-			if (current.x >= 0 && current.x <= 1 && current.y >= 0 && current.y <= 1) {
-				Point new_prev;
-				move_in_rectangle(current, prev, &new_prev);
-				vector_push_back(vertices, rect.x + rect.w*new_prev.x);
-				vector_push_back(vertices, rect.y + rect.h*new_prev.y);
-				vector_push_back(vertices, rect.x + rect.w*current.x);
-				vector_push_back(vertices, rect.y + rect.h*current.y);
-				curve_started = true;
-				
-			// Both points are out of the graph but they segment intersects the graph area. 
-			} else if (intersect_rectangle(prev, current)) {
-				Point new_current, new_prev;
-				move_in_rectangle(prev, current, &new_current);
-				move_in_rectangle(current, prev, &new_prev);
-				vector_push_back(vertices, rect.x + rect.w*new_prev.x);
-				vector_push_back(vertices, rect.y + rect.h*new_prev.y);
-				vector_push_back(vertices, rect.x + rect.w*new_current.x);
-				vector_push_back(vertices, rect.y + rect.h*new_current.y);
-			}
+/// @brief Pushes new interleaved points into the curve's buffers.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param xy The coordinates of the points, as x0,y0,x1,y1,...
+/// @param n The number of points to add. xy must be 2*n values long.
+/// @note The points are split by chunks to avoid any allocation.
+void curve_push_xy_interleaved_raw(Curve *curve, const float *xy, size_t n) {
+	if (n + curve->x_val->size > curve->x_val->cap) {
+		fprintf(stderr, "[ARGUS]: warning: the space left in the buffers of a graph "
+			"is lower than the amount of data that will be pushed. The oldset data will be erased.\n");
+	}
+	float x[256];
+	float y[256];
+	while (n) {
+		const size_t len = n < 256 ? n : 256;
+		for (size_t i = 0; i < len; ++i) {
+			x[i] = xy[2*i];
+			y[i] = xy[2*i+1];
 		}
-
-		// Next point.
-		prev = current;
-		++i;
+		curve_push_x(curve, x, len);
+		curve_push_y(curve, y, len);
+		xy += 2*len;
+		n -= len;
 	}
 }
 
+/// @brief Streams new x-axis data into the curve's queue.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+/// @note This never blocks and can be called from one producer thread while the curve is rendered.
+/// @note The data is moved into the curve's buffer on the next call to curve_drain_streams.
+void curve_stream_x_data_raw(Curve *curve, const float *data, size_t n) {
+	if (!curve->x_queue) {
+		fprintf(stderr, "[ARGUS]: warning: the curve x axis capacity hasn't been set! The data won't be streamed.\n");
+		return;
+	}
+	if (spscqueue_push(curve->x_queue, data, n) < n) {
+		fprintf(stderr, "[ARGUS]: warning: the stream queue of the x axis of a graph is full. "
+			"The newest data will be dropped.\n");
+	}
+}
 
+/// @brief Streams new y-axis data into the curve's queue.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param data The raw buffer containing the data.
+/// @param n The number of values to add.
+/// @note This never blocks and can be called from one producer thread while the curve is rendered.
+/// @note The data is moved into the curve's buffer on the next call to curve_drain_streams.
+void curve_stream_y_data_raw(Curve *curve, const float *data, size_t n) {
+	if (!curve->y_queue) {
+		fprintf(stderr, "[ARGUS]: warning: the curve y axis capacity hasn't been set! The data won't be streamed.\n");
+		return;
+	}
+	if (spscqueue_push(curve->y_queue, data, n) < n) {
+		fprintf(stderr, "[ARGUS]: warning: the stream queue of the y axis of a graph is full. "
+			"The newest data will be dropped.\n");
+	}
+}
 
+/// @brief Streams new points into the curve's queues.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param x The x-axis values of the points.
+/// @param y The y-axis values of the points.
+/// @param n The number of points to add.
+/// @note This never blocks and can be called from one producer thread while the curve is rendered.
+/// @note If the queues are full, whole points are dropped, so x and y never get out of sync.
+void curve_stream_xy_data_raw(Curve *curve, const float *x, const float *y, size_t n) {
+	if (!curve->x_queue || !curve->y_queue) {
+		fprintf(stderr, "[ARGUS]: warning: the curve capacity hasn't been set! The data won't be streamed.\n");
+		return;
+	}
+	const size_t space_x = spscqueue_space(curve->x_queue);
+	const size_t space_y = spscqueue_space(curve->y_queue);
+	const size_t space = space_x < space_y ? space_x : space_y;
+	if (space < n) {
+		fprintf(stderr, "[ARGUS]: warning: the stream queues of a graph are full. "
+			"The newest data will be dropped.\n");
+		n = space;
+	}
+	spscqueue_push(curve->x_queue, x, n);
+	spscqueue_push(curve->y_queue, y, n);
+}
 
-
-/// @brief 
-/// @param x 
-/// @param y 
-/// @param vertices 
-/// @param limits 
-/// @param rect 
-void curve_prepare_scatter(RingBuffer *x, RingBuffer *y, Vector *vertices, const Rect limits, const Rect rect) {
-	const size_t size = x->size;
-	if (size < 2) return;
-	const float x_min = limits.x;
-	const float y_min = limits.y;
-	const float x_max = limits.w;
-	const float y_max = limits.h;
-
-	// Adds all the points of the curve if they're visible.
-	bool curve_started = false;
-	size_t i = 0;
-	Point current;
-	while (i < size) {
-
-		// Gets the current point coordinates and checks what should be added to the point vector.
-		current.x = (ringbuffer_at(x, i)-x_min) / (x_max-x_min);
-		current.y = 1.0f-(ringbuffer_at(y, i)-y_min) / (y_max-y_min);
-		if (current.x >= 0 && current.x <= 1 && current.y >= 0 && current.y <= 1) {
-
-
-			///////////////////////////////////////////////////////////
-			//                   ADDS VERTICES HERE                  //
-			///////////////////////////////////////////////////////////
-
-
+/// @brief Streams new interleaved points into the curve's queues.
+/// @param curve Pointer to the curve receiving the new data.
+/// @param xy The coordinates of the points, as x0,y0,x1,y1,...
+/// @param n The number of points to add. xy must be 2*n values long.
+/// @note This never blocks and can be called from one producer thread while the curve is rendered.
+/// @note If the queues are full, whole points are dropped, so x and y never get out of sync.
+void curve_stream_xy_interleaved_raw(Curve *curve, const float *xy, size_t n) {
+	if (!curve->x_queue || !curve->y_queue) {
+		fprintf(stderr, "[ARGUS]: warning: the curve capacity hasn't been set! The data won't be streamed.\n");
+		return;
+	}
+	const size_t space_x = spscqueue_space(curve->x_queue);
+	const size_t space_y = spscqueue_space(curve->y_queue);
+	const size_t space = space_x < space_y ? space_x : space_y;
+	if (space < n) {
+		fprintf(stderr, "[ARGUS]: warning: the stream queues of a graph are full. "
+			"The newest data will be dropped.\n");
+		n = space;
+	}
+	float x[256];
+	float y[256];
+	while (n) {
+		const size_t len = n < 256 ? n : 256;
+		for (size_t i = 0; i < len; ++i) {
+			x[i] = xy[2*i];
+			y[i] = xy[2*i+1];
 		}
-
+		spscqueue_push(curve->x_queue, x, len);
+		spscqueue_push(curve->y_queue, y, len);
+		xy += 2*len;
+		n -= len;
 	}
 }
 
+/// @brief Moves the points of a pair of queues into the curve's buffers.
+/// @param curve The curve to update.
+/// @param x_queue The queue of x-axis values.
+/// @param y_queue The queue of y-axis values.
+/// @return true if new points were added to the curve.
+/// @note Only complete points are moved, the extra x or y values wait for their counterpart.
+static bool curve_drain_queues(Curve *curve, SPSCQueue *x_queue, SPSCQueue *y_queue) {
+	if (!x_queue || !y_queue) return false;
+	const size_t n_x = spscqueue_size(x_queue);
+	const size_t n_y = spscqueue_size(y_queue);
+	size_t n = n_x < n_y ? n_x : n_y;
+	if (!n) return false;
+
+	// Moves the points by chunks to avoid any allocation.
+	float chunk[256];
+	while (n) {
+		const size_t len = n < 256 ? n : 256;
+		spscqueue_pop(x_queue, chunk, len);
+		curve_push_x(curve, chunk, len);
+		spscqueue_pop(y_queue, chunk, len);
+		curve_push_y(curve, chunk, len);
+		n -= len;
+	}
+	return true;
+}
 
+/// @brief Moves the streamed data from the curve's queues into its buffers.
+/// @param curve The curve to update.
+/// @return true if new points were added to the curve.
+/// @note Both the data streamed by the user and the data produced by the update thread are moved.
+bool curve_drain_streams(Curve *curve) {
+	const bool streamed = curve_drain_queues(curve, curve->x_queue, curve->y_queue);
+	const bool updated = curve_drain_queues(curve, curve->x_update_queue, curve->y_update_queue);
+	return streamed || updated;
+}
 
 
 
-/*
-
-
-
-largeur/hauteur -> uniform
-
-offset -> par instance
-
-vertices -> identiques, instance ?
-
-
-
-
-
-*/
+/// @brief Uploads the raw values of some points of the curve into a VBO.
+/// @param curve The curve to upload.
+/// @param vbo The VBO where to upload the points. Its lists are the x and y values.
+/// @param x_offset The byte offset of the x-axis values in the VBO.
+/// @param y_offset The byte offset of the y-axis values in the VBO.
+/// @param wrap true if there is room for a vertex after the capacity of the curve.
+/// @param first The id of the first point to upload in the curve buffers.
+/// @param n The number of points to upload.
+/// @note The point stored in the slot i of the x buffer goes into the vertex i of the lists.
+/// If wrap is true, the vertex cap duplicates the vertex 0, so that a wrapped curve
+/// can be drawn as two strips.
+static void curve_upload(Curve *curve, VBO *vbo, size_t x_offset, size_t y_offset, bool wrap, size_t first, size_t n) {
+	const RingBuffer *x = curve->x_val;
+	const RingBuffer *y = curve->y_val;
+	const size_t cap = x->cap;
+
+	// Copies the values by contiguous runs of slots.
+	const size_t end = first + n;
+	while (first < end) {
+		const size_t x_slot = (x->start + first) % cap;
+		const size_t y_slot = (y->start + first) % cap;
+		size_t run = end - first;
+		if (run > cap - x_slot) run = cap - x_slot;
+		if (run > cap - y_slot) run = cap - y_slot;
+		vbo_update(vbo, x_offset + x_slot*sizeof(float), run*sizeof(float), x->data+x_slot);
+		vbo_update(vbo, y_offset + x_slot*sizeof(float), run*sizeof(float), y->data+y_slot);
+		if (!x_slot && wrap) {
+			vbo_update(vbo, x_offset + cap*sizeof(float), sizeof(float), x->data+x_slot);
+			vbo_update(vbo, y_offset + cap*sizeof(float), sizeof(float), y->data+y_slot);
+		}
+		first += run;
+	}
+}
 
+/// @brief Prepares the scatter InstancedVAO of a curve.
+/// @param curve The curve to prepare.
+/// @return false if there was an error.
+/// @note The instance lists mirror the slots of the curve buffers, so they're kept between the calls
+/// and only the points added since the last call are uploaded. Since the order of the markers 
+/// doesn't matter, the size first slots are drawn whatever the start of the buffers is.
+static bool curve_prepare_scatter(Curve *curve) {
+	const size_t cap = curve->x_val->cap;
+	const size_t size = curve->x_val->size;
+	if (curve->scatter_vao && curve->scatter_vao->size != cap) vao_free_instanced(&curve->scatter_vao);
+	if (!curve->scatter_vao) {
+		float quad[8] = {-1,-1, 1,-1, -1,1, 1,1};
+		void *shared_data = quad;
+		int shared_sizes = 2;
+		int shared_gl_types = GL_FLOAT;
+		int instance_sizes[2] = {1,1};
+		int instance_gl_types[2] = {GL_FLOAT,GL_FLOAT};
+		curve->scatter_vao = vao_create_instanced_dynamic(
+			&shared_data, &shared_sizes, &shared_gl_types, 4, 1,
+			instance_sizes, instance_gl_types, cap, 2
+		);
+		curve->scatter_valid = false;
+		if (!curve->scatter_vao) {
+			fprintf(stderr, "[ARGUS]: error: unable to create an InstancedVAO for a curve !\n");
+			return false;
+		}
+	}
 
+	// Uploads every point if the VAO is new, or only the new ones otherwise.
+	size_t pending = curve->x_pending > curve->y_pending ? curve->x_pending : curve->y_pending;
+	if (!curve->scatter_valid || pending > size) pending = size;
+	curve_upload(curve, curve->scatter_vao->vbo_instanced, 0, cap*sizeof(float), false, size-pending, pending);
+	curve->x_pending = 0;
+	curve->y_pending = 0;
+	curve->scatter_valid = true;
+	curve->gpu_valid = false;
+	return true;
+}
 
+/// @brief Enables or disables the min/max pyramid of a curve.
+/// @param curve The curve to modify.
+/// @param enable true to keep a pyramid of the y-axis values.
+/// @note The pyramid is built over the values already in the buffer, then updated on each push.
+/// It makes the decimation cost independent of the number of points, at the price of 
+/// about 2/PYRAMID_BLOCK extra floats per point.
+void curve_set_pyramid(Curve *curve, bool enable) {
+	curve->use_pyramid = enable;
+	if (!enable) pyramid_free(&curve->y_pyramid);
+	else if (curve->y_val && !curve->y_pyramid) curve->y_pyramid = pyramid_create(curve->y_val->cap);
+}
 
+/// @brief Prepares the decimated vertices of a curve with sorted x-axis values.
+/// @param curve The curve to prepare.
+/// @param limits The axis limits.
+/// @param columns The width in pixels of the rect where the curve is drawn.
+/// @return false if there was an error.
+/// @note At most 4 points are kept for each pixel column, so the cost of the draw only depends on the graph size.
+static bool curve_prepare_m4(Curve *curve, const Rect limits, size_t columns) {
+	curve->decimated = true;
+
+	// Resizes the decimation buffers if the graph is wider than before.
+	const size_t cap = DECIMATE_M4_MAX(columns);
+	if (cap > curve->m4_cap) {
+		vertexarena_release(&curve->m4_block);
+		free(curve->m4_data);
+		curve->m4_cap = 0;
+		curve->m4_data = malloc(2*cap*sizeof(float));
+		if (!curve->m4_data) {
+			fprintf(stderr, "[ARGUS]: error: unable to malloc the decimation buffer of a curve!\n");
+			return false;
+		}
+		curve->m4_cap = cap;
+	}
+	if (!curve->m4_block.len && !vertexarena_alloc(&curve->m4_block, curve->m4_cap)) {
+		fprintf(stderr, "[ARGUS]: error: unable to allocate the vertices of a curve!\n");
+		return false;
+	}
 
+	// Decimates the visible part of the curve and uploads it.
+	float *out_x = curve->m4_data;
+	float *out_y = curve->m4_data + curve->m4_cap;
+	size_t n;
+	if (curve->y_pyramid) {
+		pyramid_flush(curve->y_pyramid, curve->y_val->data);
+		n = decimate_m4_pyramid(curve->x_val, curve->y_val, curve->y_pyramid, 
+			limits.x, limits.w, columns, out_x, out_y);
+	} else n = decimate_m4(curve->x_val, curve->y_val, limits.x, limits.w, columns, out_x, out_y);
+	size_t x_offset, y_offset;
+	vertexarena_offsets(&curve->m4_block, &x_offset, &y_offset);
+	vbo_update(vertexarena_vbo(), x_offset, n*sizeof(float), out_x);
+	vbo_update(vertexarena_vbo(), y_offset, n*sizeof(float), out_y);
+	curve->ranges = n ? 1 : 0;
+	curve->range_first[0] = curve->m4_block.first;
+	curve->range_count[0] = n;
+	return true;
+}
 
-/// @brief Prepares the VAO of a curve in a given graph.
+/// @brief Prepares the vertices of a curve in a given graph.
 /// @param curve The curve to prepare.
 /// @param x_axis The x axis of the graph.
 /// @param y_axis The y axis of the graph.
 /// @param rect The rect of the graph where to draw the curve.
+/// @param window_width The width of the window.
 /// @return false if there was an error.
-bool curve_prepare_dynamic(Curve *curve, const Axis *x_axis, const Axis *y_axis, const Rect rect) {
-	vao_free(&curve->curve_vao);
+/// @note The vertices are kept in a block of the vertex arena between the calls and only the 
+/// points added since the last call are uploaded. The raw values are projected by the data shader, so the axis limits don't matter here.
+/// @note If the x-axis values are sorted and there are more than 4 points per pixel column,
+/// a decimated curve is drawn instead.
+bool curve_prepare_dynamic(Curve *curve, const Axis *x_axis, const Axis *y_axis, const Rect rect, int window_width) {
+	curve->ranges = 0;
+	curve->decimated = false;
+	if (!curve->x_val || !curve->y_val) return true;
 
 	// Gets the number of points int the curve.
-	if (curve->x_val->size != curve->y_val->size) {
+	const size_t size = curve->x_val->size;
+	if (size != curve->y_val->size) {
 		fprintf(stderr, "[ARGUS]: error: the curve x and y buffers are not of the same size!\n");
 		return false;
 	}
-	if (!curve->x_val->size) return true;
+	if (!size) return true;
 
 	// Gets the axis limits.
 	const Rect limits = {x_axis->min, y_axis->min, x_axis->max, y_axis->max};
-
-	// Creates the buffer to store the points vertices.
-	Vector *point_vec = vector_create(64);
-	if (!point_vec) {
-		fprintf(stderr, "[ARGUS]: error: unable to create a vector to store curve points!\n");
-		return false;
+	if (curve->mode == DRAW_SCATTER) return curve_prepare_scatter(curve);
+	curve->scatter_valid = false;
+
+	// Decimates the curve if it has far more points than pixel columns.
+	const size_t columns = rect.w*window_width + 1;
+	if (curve_x_sorted(curve) && size > 4*columns) {
+		curve->gpu_valid = false;
+		return curve_prepare_m4(curve, limits, columns);
 	}
 
-	// Generates the vertices according to the drawing mode.
-	if (curve->mode == DRAW_SCATTER) curve_prepare_scatter(curve->x_val, curve->y_val, point_vec, limits, rect);
-	else curve_prepare_curve(curve->x_val, curve->y_val, point_vec, limits, rect);
-	if (!vector_size(point_vec)) return true;
+	// Allocates the persistent block the first time, with one extra vertex for the wrap-around.
+	const size_t cap = curve->x_val->cap;
+	if (curve->curve_block.len != cap+1) {
+		curve->gpu_valid = false;
+		if (!vertexarena_alloc(&curve->curve_block, cap+1)) {
+			fprintf(stderr, "[ARGUS]: error: unable to allocate the vertices of a curve!\n");
+			return false;
+		}
+	}
 
-	// Creates the VAO.
-	void *data = point_vec->data;
-	int sizes = 2;
-	int gl_types = GL_FLOAT;
-	curve->curve_vao = vao_create(&data, &sizes, &gl_types, vector_size(point_vec)/2,1);
-	vector_free(&point_vec);
-	if (!curve->curve_vao) {
-		fprintf(stderr, "[ARGUS]: error: unable to create a VAO for a curve !\n");
-		return false;
+	// Uploads every point if the block is new, or only the new ones otherwise.
+	size_t pending = curve->x_pending > curve->y_pending ? curve->x_pending : curve->y_pending;
+	if (!curve->gpu_valid || pending > size) pending = size;
+	size_t x_offset, y_offset;
+	vertexarena_offsets(&curve->curve_block, &x_offset, &y_offset);
+	curve_upload(curve, vertexarena_vbo(), x_offset, y_offset, true, size-pending, pending);
+	curve->x_pending = 0;
+	curve->y_pending = 0;
+	curve->gpu_valid = true;
+
+	// Calculates the ranges of vertices to draw.
+	const size_t start = curve->x_val->start % cap;
+	curve->ranges = 1;
+	curve->range_first[0] = curve->curve_block.first + start;
+	curve->range_count[0] = start ? cap+1-start : size;
+	if (start) {
+		curve->ranges = 2;
+		curve->range_first[1] = curve->curve_block.first;
+		curve->range_count[1] = start;
 	}
 	return true;
 }
 
+/// @brief Frees the graphics components of a curve at the end of the render.
+/// @param curve The curve to reset.
+void curve_reset_graphics(Curve *curve) {
+	vertexarena_release(&curve->curve_block);
+	vertexarena_release(&curve->m4_block);
+	vao_free_instanced(&curve->scatter_vao);
+	curve->scatter_valid = false;
+	free(curve->m4_data);
+	curve->m4_data = NULL;
+	curve->m4_cap = 0;
+	curve->decimated = false;
+	curve->gpu_valid = false;
+	curve->ranges = 0;
+}
+
 /// @brief Sets the update function of a curve.
 /// @param curve The curve that will be updated.
 /// @param func The function used for the update.
@@ -335,22 +647,124 @@ void curve_set_update_function(Curve *curve, void (*func)(float *x, float *y, do
 		return;
 	}
 	curve->update = func;
+	curve->batch_update = NULL;
+}
+
+/// @brief Sets the batch update function of a curve.
+/// @param curve The curve that will be updated.
+/// @param func The function used for the update.
+/// @param n The maximal number of points produced by each call.
+/// @note func gets writable spans x and y of length len <= n and the timestep dt between two points.
+/// It writes the next points directly into the curve buffers and returns the number of points written.
+/// @note A call can be split in several calls when the span reaches the end of the buffers. 
+/// func must keep its own state between the calls, the spans don't hold the previous points.
+/// @note This replaces the update function set by curve_set_update_function.
+void curve_set_batch_update_function(Curve *curve, size_t (*func)(float *x, float *y, size_t n, double dt), size_t n) {
+	if (!curve->x_val || !curve->y_val) {
+		fprintf(stderr, "[ARGUS]: warning: the curve capacity "
+			"hasn't been set! The batch update function won't be called.\n");
+		return;
+	}
+	if (!n) {
+		fprintf(stderr, "[ARGUS]: warning: a batch update function must produce at least one point! "
+			"The batch update function won't be called.\n");
+		return;
+	}
+	curve->batch_update = func;
+	curve->batch_size = n;
+	curve->update = NULL;
+}
+
+/// @brief Calls the batch update function of the curve.
+/// @param curve The curve to update.
+/// @param dt The timestep between each point.
+/// @note The points are written directly in the buffers, without any copy.
+static void curve_update_batch(Curve *curve, double dt) {
+	size_t left = curve->batch_size;
+	while (left) {
+		size_t len_x = left;
+		size_t len_y = left;
+		float *x = ringbuffer_reserve(curve->x_val, &len_x);
+		float *y = ringbuffer_reserve(curve->y_val, &len_y);
+		const size_t len = len_x < len_y ? len_x : len_y;
+		size_t n = curve->batch_update(x, y, len, dt);
+		if (n > len) n = len;
+		curve_track_y(curve, y, n);
+		ringbuffer_commit(curve->x_val, n);
+		ringbuffer_commit(curve->y_val, n);
+		curve_track_x(curve, x, n);
+		if (n < len) return;
+		left -= n;
+	}
 }
 
 /// @brief Calls the update function of the curve.
 /// @param curve The function to update.
 /// @param dt The timestep between each update.
 void curve_update(Curve *curve, double dt) {
-	if (!curve->update || !curve->x_val || !curve->y_val) return;
-	float x = curve->x_val->size ? ringbuffer_at(curve->x_val, 0) : 0.0f;
-	float y = curve->y_val->size ? ringbuffer_at(curve->y_val, 0) : 0.0f;
+	if (!curve->x_val || !curve->y_val) return;
+	if (curve->batch_update) {
+		curve_update_batch(curve, dt);
+		return;
+	}
+	if (!curve->update) return;
+	float x = curve->x_val->size ? ringbuffer_back(curve->x_val) : 0.0f;
+	float y = curve->y_val->size ? ringbuffer_back(curve->y_val) : 0.0f;
 	curve->update(&x, &y, dt);
-	ringbuffer_push_back(curve->x_val, x);
-	ringbuffer_push_back(curve->y_val, y);
-	if (x < curve->x_min) curve->x_min = x;
-	if (x > curve->x_max) curve->x_max = x;
-	if (y < curve->y_min) curve->y_min = y;
-	if (y > curve->y_max) curve->y_max = y;
+	curve_push_x(curve, &x, 1);
+	curve_push_y(curve, &y, 1);
+}
+
+/// @brief Prepares the curve to be updated from the update thread.
+/// @param curve The curve to prepare.
+/// @note Must be called from the render thread before the update thread starts.
+void curve_update_start(Curve *curve) {
+	if (!curve->x_val || !curve->y_val) return;
+	curve->update_x = curve->x_val->size ? ringbuffer_back(curve->x_val) : 0.0f;
+	curve->update_y = curve->y_val->size ? ringbuffer_back(curve->y_val) : 0.0f;
+}
+
+/// @brief Calls the update function of the curve from the update thread.
+/// @param curve The curve to update.
+/// @param dt The timestep between each update.
+/// @return false if there was not enough room in the update queues. Nothing was produced then.
+/// @note The new points are published into the update queues and moved into the buffers
+/// by the render thread, in curve_drain_streams. The buffers are never touched here.
+bool curve_update_async(Curve *curve, double dt) {
+	SPSCQueue *x_queue = curve->x_update_queue;
+	SPSCQueue *y_queue = curve->y_update_queue;
+	if (!x_queue || !y_queue) return true;
+	const size_t space_x = spscqueue_space(x_queue);
+	const size_t space_y = spscqueue_space(y_queue);
+	const size_t space = space_x < space_y ? space_x : space_y;
+
+	// Produces a single point from the last one.
+	if (!curve->batch_update) {
+		if (!curve->update) return true;
+		if (!space) return false;
+		curve->update(&curve->update_x, &curve->update_y, dt);
+		spscqueue_push(x_queue, &curve->update_x, 1);
+		spscqueue_push(y_queue, &curve->update_y, 1);
+		return true;
+	}
+
+	// Produces a batch of points directly into the queues.
+	size_t left = curve->batch_size < x_queue->cap ? curve->batch_size : x_queue->cap;
+	if (space < left) return false;
+	while (left) {
+		size_t len_x = left;
+		size_t len_y = left;
+		float *x = spscqueue_reserve(x_queue, &len_x);
+		float *y = spscqueue_reserve(y_queue, &len_y);
+		const size_t len = len_x < len_y ? len_x : len_y;
+		size_t n = curve->batch_update(x, y, len, dt);
+		if (n > len) n = len;
+		spscqueue_commit(x_queue, n);
+		spscqueue_commit(y_queue, n);
+		if (n < len) break;
+		left -= n;
+	}
+	return true;
 }
 
 /// @brief Creates a VAO for a curve.
@@ -1,11 +1,16 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdatomic.h>
 #include "ring_buffer.h"
+#include "spsc_queue.h"
+#include "pyramid.h"
+#include "minmax_window.h"
 #include "vector.h"
 #include "axis.h"
 #include "structs.h"
 #include "vao.h"
+#include "vertex_arena.h"
 #include "enums.h"
 
 
@@ -14,16 +19,47 @@
 /// @brief Represents a curve with associated data buffers and axis limits.
 typedef struct {
     Color color;    ///< The color of the curve.
-	VAO *curve_vao; ///< The VAO of the curve.
+	ArenaBlock curve_block; ///< The vertices of the curve in the vertex arena.
     RingBuffer *x_val;	///< Buffer storing x-axis values.
     RingBuffer *y_val;	///< Buffer storing y-axis values.
+    SPSCQueue *x_queue;	///< Queue of x-axis values streamed while the curve is shown.
+    SPSCQueue *y_queue;	///< Queue of y-axis values streamed while the curve is shown.
+    atomic_bool stream_opened;	///< true if the stream queues are owned by the thread of an ArgusStream.
+    SPSCQueue *x_update_queue;	///< Queue of x-axis values produced by the update thread.
+    SPSCQueue *y_update_queue;	///< Queue of y-axis values produced by the update thread.
+    float update_x;	///< Last x-axis value produced by the update thread.
+    float update_y;	///< Last y-axis value produced by the update thread.
+    MinMaxWindow *x_window;	///< Extrema of the x-axis values in the buffer.
+    MinMaxWindow *y_window;	///< Extrema of the y-axis values in the buffer.
     void (*update)(float *x, float *y, double dt); ///< update function.
-    float x_min;	///< Minimum x-axis value.
-    float x_max;	///< Maximum x-axis value.
-    float y_min;	///< Minimum y-axis value.
-    float y_max;	///< Maximum y-axis value.
+    size_t (*batch_update)(float *x, float *y, size_t n, double dt); ///< batch update function.
+    size_t batch_size;	///< Maximal number of points produced by each update.
+    float update_frequency;	///< Number of updates per second of the curve, 0 to use the global one.
+    float update_timestep;	///< Timestep given to the update function of the curve, 0 to use the global one.
+    float x_min;	///< Minimum x-axis value in the buffer.
+    float x_max;	///< Maximum x-axis value in the buffer.
+    float y_min;	///< Minimum y-axis value in the buffer.
+    float y_max;	///< Maximum y-axis value in the buffer.
     DrawMode mode;  ///< The draw mode to use for the curve.
-    bool to_render; ///< true if the VAO must be recreated.
+    bool to_render; ///< true if the curve data changed since its VAO was prepared.
+    size_t x_pending;	///< Number of x-axis values added since the last upload.
+    size_t y_pending;	///< Number of y-axis values added since the last upload.
+    bool gpu_valid;		///< true if the VAO content matches the buffers, apart from the pending values.
+    size_t x_count;		///< Total number of x-axis values pushed since the buffers were created.
+    size_t x_descent;	///< Number of x-axis values pushed before the last decreasing one, 0 if there is none.
+    float x_last;		///< Last x-axis value pushed.
+    InstancedVAO *scatter_vao;	///< The InstancedVAO of the curve in scatter mode.
+    bool scatter_valid;	///< true if the scatter VAO content matches the buffers, apart from the pending values.
+    float marker_size;	///< The diameter of the scatter markers in pixels.
+    bool use_pyramid;	///< true if a min/max pyramid of the y-axis values must be kept.
+    Pyramid *y_pyramid;	///< The min/max pyramid of the y-axis values, used for the decimation.
+    ArenaBlock m4_block;	///< The vertices of the decimated curve in the vertex arena.
+    float *m4_data;		///< Buffer of the decimated x-axis values followed by the y-axis values.
+    size_t m4_cap;		///< Maximal number of points in the decimated curve.
+    bool decimated;		///< true if the decimated vertices must be drawn instead of the curve ones.
+    int ranges;			///< Number of vertex ranges to draw (0 to 2).
+    GLint range_first[2];	///< First vertex of each range in the vertex arena.
+    GLsizei range_count[2];	///< Number of vertices of each range.
 
 } Curve;
 
@@ -50,14 +86,50 @@ void curve_push_x_data_raw(Curve *curve, float *data, size_t n);
 // Pushes new y-axis data into the curve's buffer.
 void curve_push_y_data_raw(Curve *curve, float *data, size_t n);
 
-// Prepares the VAO of a curve in a given graph.
-bool curve_prepare_dynamic(Curve *curve, const Axis *x_axis, const Axis *y_axis, const Rect rect);
+// Pushes new points into the curve's buffers.
+void curve_push_xy_data_raw(Curve *curve, const float *x, const float *y, size_t n);
+
+// Pushes new interleaved points into the curve's buffers.
+void curve_push_xy_interleaved_raw(Curve *curve, const float *xy, size_t n);
+
+// Streams new x-axis data into the curve's queue.
+void curve_stream_x_data_raw(Curve *curve, const float *data, size_t n);
+
+// Streams new y-axis data into the curve's queue.
+void curve_stream_y_data_raw(Curve *curve, const float *data, size_t n);
+
+// Streams new points into the curve's queues.
+void curve_stream_xy_data_raw(Curve *curve, const float *x, const float *y, size_t n);
+
+// Streams new interleaved points into the curve's queues.
+void curve_stream_xy_interleaved_raw(Curve *curve, const float *xy, size_t n);
+
+// Moves the streamed data from the curve's queues into its buffers.
+bool curve_drain_streams(Curve *curve);
+
+// Enables or disables the min/max pyramid of a curve.
+void curve_set_pyramid(Curve *curve, bool enable);
+
+// Prepares the vertices of a curve in a given graph.
+bool curve_prepare_dynamic(Curve *curve, const Axis *x_axis, const Axis *y_axis, const Rect rect, int window_width);
+
+// Frees the graphics components of a curve at the end of the render.
+void curve_reset_graphics(Curve *curve);
 
 // Sets the update function of a curve.
 void curve_set_update_function(Curve *curve, void (*func)(float *x, float *y, double dt));
 
+// Sets the batch update function of a curve.
+void curve_set_batch_update_function(Curve *curve, size_t (*func)(float *x, float *y, size_t n, double dt), size_t n);
+
 /// Calls the update function of the curve.
 void curve_update(Curve *curve, double dt);
 
+// Prepares the curve to be updated from the update thread.
+void curve_update_start(Curve *curve);
+
+// Calls the update function of the curve from the update thread.
+bool curve_update_async(Curve *curve, double dt);
+
 // Creates a VAO for a curve.
 VAO *curve_prepare_vao(float *x_val, float *y_val, int n);
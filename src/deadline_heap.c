@@ -0,0 +1,93 @@
+#include "deadline_heap.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+
+/// @brief Allocates a DeadlineHeap that can store cap deadlines.
+/// @param cap The maximal number of deadlines.
+/// @return The initialized heap.
+DeadlineHeap *deadlineheap_create(size_t cap) {
+	if (cap <= 0) {
+		fprintf(stderr, "[ARGUS]: error: DeadlineHeap capacity must be greater than 0. Given capacity: %ld\n", cap);
+		return NULL;
+	}
+	DeadlineHeap *heap = malloc(sizeof(DeadlineHeap));
+	if (!heap) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the DeadlineHeap structure.\n");
+		return NULL;
+	}
+	heap->data = malloc(cap*sizeof(Deadline));
+	if (!heap->data) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the DeadlineHeap's data buffer.\n");
+		free(heap);
+		return NULL;
+	}
+	heap->size = 0;
+	heap->cap = cap;
+	return heap;
+}
+
+/// @brief Frees the memory allocated for a DeadlineHeap.
+/// @param p_heap A pointer to the pointer of the DeadlineHeap to be freed. Cannot be NULL.
+/// @note After freeing, the pointer *p_heap is set to NULL to avoid double-free.
+void deadlineheap_free(DeadlineHeap **p_heap) {
+	DeadlineHeap *heap = *p_heap;
+	if (!heap) return;
+	free(heap->data);
+	free(heap);
+	*p_heap = NULL;
+}
+
+
+/// @brief Inserts a deadline into the heap.
+/// @param heap The heap where to insert the deadline.
+/// @param time The time at which the item is due.
+/// @param id The id of the item.
+/// @return false if the heap is full.
+/// @note Runs in O(log n).
+bool deadlineheap_push(DeadlineHeap *heap, uint64_t time, size_t id) {
+	if (heap->size >= heap->cap) {
+		fprintf(stderr, "[ARGUS]: error: the DeadlineHeap is full!\n");
+		return false;
+	}
+
+	// Moves the parents that are later down, until the slot of the new deadline is found.
+	size_t i = heap->size++;
+	while (i) {
+		const size_t parent = (i - 1)/2;
+		if (heap->data[parent].time <= time) break;
+		heap->data[i] = heap->data[parent];
+		i = parent;
+	}
+	heap->data[i] = (Deadline){time, id};
+	return true;
+}
+
+/// @brief Gets the earliest deadline of the heap.
+/// @param heap The heap to read.
+/// @return The earliest deadline, or NULL if the heap is empty.
+const Deadline *deadlineheap_top(const DeadlineHeap *heap) {
+	return heap->size ? heap->data : NULL;
+}
+
+/// @brief Removes the earliest deadline of the heap.
+/// @param heap The heap to update.
+/// @note Does nothing if the heap is empty. Runs in O(log n).
+void deadlineheap_pop(DeadlineHeap *heap) {
+	if (!heap->size) return;
+	const Deadline last = heap->data[--heap->size];
+
+	// Moves the earliest children up, until the slot of the last deadline is found.
+	size_t i = 0;
+	while (true) {
+		size_t child = 2*i + 1;
+		if (child >= heap->size) break;
+		if (child + 1 < heap->size && heap->data[child + 1].time < heap->data[child].time) ++child;
+		if (last.time <= heap->data[child].time) break;
+		heap->data[i] = heap->data[child];
+		i = child;
+	}
+	heap->data[i] = last;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/// @struct Deadline
+/// @brief An item scheduled at a given time.
+typedef struct {
+	uint64_t time;	///< The time at which the item is due.
+	size_t id;		///< The id of the item.
+} Deadline;
+
+/// @struct DeadlineHeap
+/// @brief A binary min-heap of deadlines, whose top is the earliest one.
+typedef struct {
+	Deadline *data;	///< The deadlines, stored as an implicit binary tree.
+	size_t size;	///< The number of deadlines in the heap.
+	size_t cap;		///< The maximal number of deadlines in the heap.
+} DeadlineHeap;
+
+
+// Allocates a DeadlineHeap that can store cap deadlines.
+DeadlineHeap *deadlineheap_create(size_t cap);
+
+// Frees the memory allocated for a DeadlineHeap.
+void deadlineheap_free(DeadlineHeap **p_heap);
+
+
+// Inserts a deadline into the heap.
+bool deadlineheap_push(DeadlineHeap *heap, uint64_t time, size_t id);
+
+// Gets the earliest deadline of the heap.
+const Deadline *deadlineheap_top(const DeadlineHeap *heap);
+
+// Removes the earliest deadline of the heap.
+void deadlineheap_pop(DeadlineHeap *heap);
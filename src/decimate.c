@@ -0,0 +1,256 @@
+#include "decimate.h"
+
+
+
+/// @brief Gets a value in a buffer without any bound check.
+/// @param buffer The buffer that contains the value.
+/// @param id The id of the value in the buffer. Must be inferior to buffer->size.
+/// @return The contained value.
+static inline float decimate_at(const RingBuffer *buffer, size_t id) {
+	if (buffer->mirrored) return buffer->data[buffer->start + id];
+	return buffer->data[(buffer->start + id) % buffer->cap];
+}
+
+/// @brief Finds the id of the first value greater or equal to val in a sorted buffer.
+/// @param buffer The buffer to search. Its values must be sorted.
+/// @param low The id from which to search.
+/// @param val The value to search.
+/// @return The id of the first value greater or equal to val, or buffer->size if there is none.
+static size_t decimate_lower_bound(const RingBuffer *buffer, size_t low, float val) {
+	size_t high = buffer->size;
+	while (low < high) {
+		const size_t mid = low + (high-low)/2;
+		if (decimate_at(buffer, mid) < val) low = mid+1;
+		else high = mid;
+	}
+	return low;
+}
+
+/// @brief Finds the id of the first value strictly greater than val in a sorted buffer.
+/// @param buffer The buffer to search. Its values must be sorted.
+/// @param val The value to search.
+/// @return The id of the first value greater than val, or buffer->size if there is none.
+static size_t decimate_upper_bound(const RingBuffer *buffer, float val) {
+	size_t low = 0;
+	size_t high = buffer->size;
+	while (low < high) {
+		const size_t mid = low + (high-low)/2;
+		if (decimate_at(buffer, mid) <= val) low = mid+1;
+		else high = mid;
+	}
+	return low;
+}
+
+/// @brief Writes the points of a column in the output buffers, in the order of the curve.
+/// @param x The x values of the curve.
+/// @param y The y values of the curve.
+/// @param ids The ids of the first, min, max and last points of the column.
+/// @param out_x The buffer where to write the x values.
+/// @param out_y The buffer where to write the y values.
+/// @return The number of points written.
+static size_t decimate_emit(const RingBuffer *x, const RingBuffer *y, size_t ids[4], float *out_x, float *out_y) {
+
+	// Sorts the 4 ids.
+	for (int i = 1; i < 4; ++i) {
+		const size_t id = ids[i];
+		int j = i;
+		while (j > 0 && ids[j-1] > id) {
+			ids[j] = ids[j-1];
+			--j;
+		}
+		ids[j] = id;
+	}
+
+	// Writes each point once.
+	size_t n = 0;
+	for (int i = 0; i < 4; ++i) {
+		if (i && ids[i] == ids[i-1]) continue;
+		out_x[n] = decimate_at(x, ids[i]);
+		out_y[n] = decimate_at(y, ids[i]);
+		++n;
+	}
+	return n;
+}
+
+/// @brief Decimates a curve with sorted x values by keeping the first, last, min and max points of each column.
+/// @param x The x values of the curve. Must be sorted.
+/// @param y The y values of the curve. Must be of the same size as x.
+/// @param x_min The minimal visible x value.
+/// @param x_max The maximal visible x value.
+/// @param columns The number of pixel columns between x_min and x_max.
+/// @param out_x The buffer where to write the x values. Must be at least DECIMATE_M4_MAX(columns) long.
+/// @param out_y The buffer where to write the y values. Must be at least DECIMATE_M4_MAX(columns) long.
+/// @return The number of points written.
+/// @note The drawn curve is the same as the full one at this resolution, since each column 
+/// keeps its vertical extent and its connections to the neighbouring columns.
+/// @note The last point before x_min and the first one after x_max are kept so that the curve
+/// still reaches the borders of the graph.
+size_t decimate_m4(const RingBuffer *x, const RingBuffer *y, float x_min, float x_max, 
+size_t columns, float *out_x, float *out_y) {
+	if (!x->size || !columns || x_max <= x_min) return 0;
+
+	// Gets the range of visible points, with a neighbour on each side.
+	size_t first = decimate_lower_bound(x, 0, x_min);
+	size_t last = decimate_upper_bound(x, x_max);
+	if (first) --first;
+	if (last == x->size) --last;
+	if (first > last) return 0;
+
+	// Gets the visible points as contiguous spans, so that the loop over them has no modulo.
+	const float *x_spans[2];
+	const float *y_spans[2];
+	size_t x_lens[2];
+	size_t y_lens[2];
+	ringbuffer_spans(x, first, last+1-first, x_spans, x_lens);
+	ringbuffer_spans(y, first, last+1-first, y_spans, y_lens);
+
+	// Goes through the points column by column, by runs that are contiguous in both buffers.
+	const float scale = columns / (x_max - x_min);
+	size_t n = 0;
+	long column = 0;
+	size_t ids[4];	// First, min, max and last point of the current column.
+	float min = 0.0f, max = 0.0f;	// Extent of the y values of the current column.
+	int x_span = 0, y_span = 0;
+	size_t x_pos = 0, y_pos = 0;
+	size_t i = first;
+	while (i <= last) {
+		size_t run = x_lens[x_span] - x_pos;
+		if (run > y_lens[y_span] - y_pos) run = y_lens[y_span] - y_pos;
+		const float *run_x = x_spans[x_span] + x_pos;
+		const float *run_y = y_spans[y_span] + y_pos;
+		for (size_t j = 0; j < run; ++j, ++i) {
+			const float val_x = run_x[j];
+			const float val_y = run_y[j];
+
+			// Gets the column of the point. The points outside of the graph get the columns -1 and columns.
+			long c;
+			if (val_x < x_min) c = -1;
+			else if (val_x >= x_max) c = columns;
+			else c = (long)((val_x - x_min) * scale);
+			if (c >= (long)columns && val_x <= x_max) c = columns-1;
+
+			// Starts a new column or updates the current one.
+			if (i == first || c != column) {
+				if (i != first) n += decimate_emit(x, y, ids, out_x+n, out_y+n);
+				column = c;
+				ids[0] = ids[1] = ids[2] = ids[3] = i;
+				min = max = val_y;
+				continue;
+			}
+			if (val_y < min) {
+				min = val_y;
+				ids[1] = i;
+			}
+			if (val_y > max) {
+				max = val_y;
+				ids[2] = i;
+			}
+			ids[3] = i;
+		}
+		x_pos += run;
+		y_pos += run;
+		if (x_pos == x_lens[x_span]) {
+			++x_span;
+			x_pos = 0;
+		}
+		if (y_pos == y_lens[y_span]) {
+			++y_span;
+			y_pos = 0;
+		}
+	}
+	n += decimate_emit(x, y, ids, out_x+n, out_y+n);
+	return n;
+}
+
+/// @brief Gets the minimal and maximal values of a range of points of a buffer.
+/// @param buffer The buffer that contains the values.
+/// @param pyramid The min/max pyramid of the buffer.
+/// @param first The id of the first point of the range.
+/// @param last The id after the last point of the range. Must be greater than first.
+/// @param min Where to store the minimal value.
+/// @param max Where to store the maximal value.
+static void decimate_minmax(const RingBuffer *buffer, const Pyramid *pyramid, 
+size_t first, size_t last, float *min, float *max) {
+	const size_t slot = (buffer->start + first) % buffer->cap;
+	const size_t end = slot + last - first;
+	if (end <= buffer->cap) {
+		pyramid_query(pyramid, buffer->data, slot, end, min, max);
+		return;
+	}
+
+	// The range wraps around the end of the buffer.
+	float min2, max2;
+	pyramid_query(pyramid, buffer->data, slot, buffer->cap, min, max);
+	pyramid_query(pyramid, buffer->data, 0, end - buffer->cap, &min2, &max2);
+	if (min2 < *min) *min = min2;
+	if (max2 > *max) *max = max2;
+}
+
+/// @brief Decimates a curve with sorted x values using the min/max pyramid of its y values.
+/// @param x The x values of the curve. Must be sorted.
+/// @param y The y values of the curve. Must be of the same size as x.
+/// @param pyramid The min/max pyramid of the y values. Must be flushed.
+/// @param x_min The minimal visible x value.
+/// @param x_max The maximal visible x value.
+/// @param columns The number of pixel columns between x_min and x_max.
+/// @param out_x The buffer where to write the x values. Must be at least DECIMATE_M4_MAX(columns) long.
+/// @param out_y The buffer where to write the y values. Must be at least DECIMATE_M4_MAX(columns) long.
+/// @return The number of points written.
+/// @note Unlike decimate_m4, the points of a column are never read one by one: the bounds of each 
+/// column are found by binary search and its extent is read from the pyramid. The cost only depends
+/// on the number of columns and on the logarithm of the number of points.
+/// @note The min and max points of a column are placed in the middle of the column, which
+/// doesn't change the rendered curve at this resolution.
+size_t decimate_m4_pyramid(const RingBuffer *x, const RingBuffer *y, const Pyramid *pyramid, 
+float x_min, float x_max, size_t columns, float *out_x, float *out_y) {
+	if (!x->size || !columns || x_max <= x_min) return 0;
+
+	// Gets the range of visible points.
+	const size_t first = decimate_lower_bound(x, 0, x_min);
+	const size_t last = decimate_upper_bound(x, x_max);
+	size_t n = 0;
+	if (first) {
+		out_x[n] = decimate_at(x, first-1);
+		out_y[n] = decimate_at(y, first-1);
+		++n;
+	}
+
+	// Goes through the columns.
+	const float step = (x_max - x_min) / columns;
+	size_t begin = first;
+	for (size_t c = 0; c < columns && begin < last; ++c) {
+		size_t end = last;
+		if (c+1 < columns) {
+			end = decimate_lower_bound(x, begin, x_min + (c+1)*step);
+			if (end > last) end = last;
+		}
+		if (end == begin) continue;
+
+		// Emits the first, min, max and last points of the column.
+		const float x_first = decimate_at(x, begin);
+		const float x_last = decimate_at(x, end-1);
+		out_x[n] = x_first;
+		out_y[n] = decimate_at(y, begin);
+		++n;
+		if (end - begin > 2) {
+			float min, max;
+			decimate_minmax(y, pyramid, begin, end, &min, &max);
+			out_x[n] = out_x[n+1] = (x_first + x_last) / 2;
+			out_y[n] = min;
+			out_y[n+1] = max;
+			n += 2;
+		}
+		if (end - begin > 1) {
+			out_x[n] = x_last;
+			out_y[n] = decimate_at(y, end-1);
+			++n;
+		}
+		begin = end;
+	}
+	if (last < x->size) {
+		out_x[n] = decimate_at(x, last);
+		out_y[n] = decimate_at(y, last);
+		++n;
+	}
+	return n;
+}
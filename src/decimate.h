@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include "ring_buffer.h"
+#include "pyramid.h"
+
+
+// Maximal number of points produced by decimate_m4 for a given number of columns.
+#define DECIMATE_M4_MAX(columns) (4*((columns)+2))
+
+
+// Decimates a curve with sorted x values by keeping the first, last, min and max points of each column.
+size_t decimate_m4(const RingBuffer *x, const RingBuffer *y, float x_min, float x_max, 
+	size_t columns, float *out_x, float *out_y);
+
+// Decimates a curve with sorted x values using the min/max pyramid of its y values.
+size_t decimate_m4_pyramid(const RingBuffer *x, const RingBuffer *y, const Pyramid *pyramid, 
+	float x_min, float x_max, size_t columns, float *out_x, float *out_y);
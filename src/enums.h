@@ -18,3 +18,12 @@ typedef enum {
 	DRAW_CURVE,		///< Draws a line made of all the points in data.
 	DRAW_SCATTER	///< Draws each point in data separately.
 } DrawMode;
+
+
+/// @enum TextColor
+/// @brief Used to index the palette the texts of a graph are drawn with.
+typedef enum {
+	TEXTCOLOR_TEXT,		///< The color of the axis titles and labels.
+	TEXTCOLOR_TITLE,	///< The color of the graph title.
+	TEXTCOLOR_SIZE
+} TextColor;
@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
@@ -57,35 +60,150 @@ int id_from_char(int c) {
 	}
 }
 
-/// @brief Creates a glyphs set from a ttf file.
+/// @struct GlyphsCacheHeader
+/// @brief The header of an atlas cached on disk, followed by its width*height distances.
+typedef struct {
+	char magic[4];		///< Always "ASDF".
+	uint32_t version;	///< The version of the cache format, GLYPHS_CACHE_VERSION.
+	int32_t size;		///< The font size the atlas was generated with.
+	int32_t spread;		///< The spread of the distance field, in pixels.
+	int32_t width;		///< The width of the atlas.
+	int32_t height;		///< The height of the atlas.
+	float ratio;		///< The glyph ratio of the font (w/h).
+} GlyphsCacheHeader;
+
+// Version of the cache format, to change each time the atlas generation changes.
+#define GLYPHS_CACHE_VERSION 1
+
+/// @brief Computes the 1D squared distance transform of a sampled function.
+/// @param f The sampled function, 0 on the features and GLYPHS_SDF_FAR elsewhere.
+/// @param n The number of samples.
+/// @param d The buffer where to write the squared distances. n floats long.
+/// @param v Scratch buffer of n ints.
+/// @param z Scratch buffer of n+1 floats.
+/// @note This is the lower envelope of parabolas of Felzenszwalb and Huttenlocher, in O(n).
+static void glyphs_edt_1d(const float *f, int n, float *d, int *v, float *z) {
+	int k = 0;
+	v[0] = 0;
+	z[0] = -GLYPHS_SDF_FAR;
+	z[1] = GLYPHS_SDF_FAR;
+	for (int q = 1; q < n; ++q) {
+		float s = ((f[q]+q*q) - (f[v[k]]+v[k]*v[k])) / (2*q-2*v[k]);
+		while (s <= z[k]) {
+			--k;
+			s = ((f[q]+q*q) - (f[v[k]]+v[k]*v[k])) / (2*q-2*v[k]);
+		}
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k+1] = GLYPHS_SDF_FAR;
+	}
+	k = 0;
+	for (int q = 0; q < n; ++q) {
+		while (z[k+1] < q) ++k;
+		d[q] = (q-v[k])*(q-v[k]) + f[v[k]];
+	}
+}
+
+/// @brief Computes the 2D squared distance transform of a grid in place.
+/// @param grid The grid, 0 on the features and GLYPHS_SDF_FAR elsewhere.
+/// @param w The width of the grid.
+/// @param h The height of the grid.
+/// @param f Scratch buffer of max(w,h) floats.
+/// @param d Scratch buffer of max(w,h) floats.
+/// @param v Scratch buffer of max(w,h) ints.
+/// @param z Scratch buffer of max(w,h)+1 floats.
+static void glyphs_edt(float *grid, int w, int h, float *f, float *d, int *v, float *z) {
+	for (int x = 0; x < w; ++x) {
+		for (int y = 0; y < h; ++y) f[y] = grid[y*w+x];
+		glyphs_edt_1d(f, h, d, v, z);
+		for (int y = 0; y < h; ++y) grid[y*w+x] = d[y];
+	}
+	for (int y = 0; y < h; ++y) {
+		memcpy(f, grid+y*w, w*sizeof(float));
+		glyphs_edt_1d(f, w, grid+y*w, v, z);
+	}
+}
+
+/// @brief Converts the coverage of each cell of the atlas into a signed distance field, in place.
+/// @param atlas The atlas, with one coverage byte per pixel.
+/// @param width The width of the atlas.
+/// @param cell_w The width of a cell.
+/// @param cell_h The height of a cell.
+/// @return false if there was an error.
+/// @note The cells are processed separately, so that no glyph bleeds into its neighbours. 
+/// 0.5 is the edge of the glyph, and GLYPHS_SDF_SPREAD pixels away from it the values reach 0 or 1.
+static bool glyphs_compute_sdf(unsigned char *atlas, int width, int cell_w, int cell_h) {
+	const int len = cell_w > cell_h ? cell_w : cell_h;
+	float *inside = malloc(2*cell_w*cell_h*sizeof(float) + (3*len+1)*sizeof(float));
+	int *v = malloc(len*sizeof(int));
+	if (!inside || !v) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc the buffers of the distance field of the glyphs !\n");
+		free(inside);
+		free(v);
+		return false;
+	}
+	float *outside = inside + cell_w*cell_h;
+	float *f = outside + cell_w*cell_h;
+	float *d = f + len;
+	float *z = d + len;
+
+	for (int i = 0; i < 160; ++i) {
+		unsigned char *cell = atlas + (i/16)*cell_h*width + (i%16)*cell_w;
+
+		// Computes the distance of each pixel to the nearest pixel inside and outside the glyph.
+		for (int y = 0; y < cell_h; ++y) {
+			for (int x = 0; x < cell_w; ++x) {
+				const bool in = cell[y*width+x] >= 128;
+				inside[y*cell_w+x] = in ? 0.0f : GLYPHS_SDF_FAR;
+				outside[y*cell_w+x] = in ? GLYPHS_SDF_FAR : 0.0f;
+			}
+		}
+		glyphs_edt(inside, cell_w, cell_h, f, d, v, z);
+		glyphs_edt(outside, cell_w, cell_h, f, d, v, z);
+
+		// Maps the signed distance, measured from the edge between the pixels, into a byte.
+		for (int y = 0; y < cell_h; ++y) {
+			for (int x = 0; x < cell_w; ++x) {
+				const float dist = outside[y*cell_w+x] > 0.0f ? 
+					sqrtf(outside[y*cell_w+x])-0.5f : 0.5f-sqrtf(inside[y*cell_w+x]);
+				float value = 0.5f + 0.5f*dist/GLYPHS_SDF_SPREAD;
+				if (value < 0.0f) value = 0.0f;
+				if (value > 1.0f) value = 1.0f;
+				cell[y*width+x] = (unsigned char)(255.0f*value + 0.5f);
+			}
+		}
+	}
+	free(inside);
+	free(v);
+	return true;
+}
+
+/// @brief Renders the glyphs of the font with SDL_ttf into a distance field atlas.
 /// @param size Font size used to generate the glyphs images.
-/// @return The generated glyphs sets. 
-Glyphs *glyphs_create(int size) {
+/// @param p_atlas Used to return the atlas, with one byte per pixel. Must be freed by the caller.
+/// @param p_width Used to return the width of the atlas.
+/// @param p_height Used to return the height of the atlas.
+/// @param p_ratio Used to return the glyph ratio of the font (w/h).
+/// @return false if there was an error.
+static bool glyphs_render_atlas(int size, unsigned char **p_atlas, int *p_width, int *p_height, float *p_ratio) {
 
 	// Loads the font from memory.
 	SDL_RWops *rw = SDL_RWFromMem((void*)UbuntuMono_ttf, UbuntuMono_len);
 	if (!rw) {
         fprintf(stderr, "[ARGUS] error: failed to create RWops: %s\n", SDL_GetError());
-		return NULL;
+		return false;
 	}
 	TTF_Font *font = TTF_OpenFontRW(rw, 1, size);
 	if (!font) {
 		fprintf(stderr, "[ARGUS] error: failed to load font: %s\n", TTF_GetError());
-		return NULL;
-	}
-
-	// Malloc the glyphs set structure.
-	Glyphs *glyphs = malloc(sizeof(Glyphs));
-	if (!glyphs) {
-		fprintf(stderr, "[ARGUS]: error: unable to malloc the glyphs structure !\n");
-		TTF_CloseFont(font);
-		return NULL;
+		return false;
 	}
 
 	// Gets the glyph dimensions and initializes the rects.
 	SDL_Rect glyph_rect, glyphs_rect;
 	TTF_SizeText(font, "M", &glyph_rect.w, &glyph_rect.h);
-	glyphs->ratio = (float)glyph_rect.w/glyph_rect.h;
+	*p_ratio = (float)glyph_rect.w/glyph_rect.h;
 	glyphs_rect.w = 16*glyph_rect.w;
 	glyphs_rect.h = 10*glyph_rect.h;
 	glyphs_rect.x = 0;
@@ -101,8 +219,7 @@ Glyphs *glyphs_create(int size) {
 	if (!surface) {
 		fprintf(stderr, "[ARGUS]: error: unable to creates the glyphs surface !\n");
 		TTF_CloseFont(font);
-		free(glyphs);
-		return NULL;
+		return false;
 	}
 	SDL_FillRect(surface, &glyphs_rect, SDL_MapRGBA(surface->format, 0,0,0,0));
 
@@ -143,13 +260,143 @@ Glyphs *glyphs_create(int size) {
 	}
 	TTF_CloseFont(font);
 
-	// Generates the texture.
+	// Keeps the coverage of each pixel, then turns it into distances.
+	const int width = surface->w;
+	const int height = surface->h;
+	unsigned char *atlas = malloc(width*height);
+	if (!atlas) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc the glyphs atlas !\n");
+		SDL_FreeSurface(surface);
+		return false;
+	}
+	for (int y = 0; y < height; ++y) {
+		const Uint32 *row = (const Uint32*)((const Uint8*)surface->pixels + y*surface->pitch);
+		for (int x = 0; x < width; ++x) atlas[y*width+x] = row[x] >> 24;
+	}
+	SDL_FreeSurface(surface);
+	if (!glyphs_compute_sdf(atlas, width, glyph_rect.w, glyph_rect.h)) {
+		free(atlas);
+		return false;
+	}
+	*p_atlas = atlas;
+	*p_width = width;
+	*p_height = height;
+	return true;
+}
+
+/// @brief Loads a distance field atlas cached on disk.
+/// @param path The path of the cache file.
+/// @param size The font size the atlas must have been generated with.
+/// @param p_atlas Used to return the atlas, with one byte per pixel. Must be freed by the caller.
+/// @param p_width Used to return the width of the atlas.
+/// @param p_height Used to return the height of the atlas.
+/// @param p_ratio Used to return the glyph ratio of the font (w/h).
+/// @return false if the file doesn't exist or doesn't match the current atlas generation.
+static bool glyphs_load_atlas(const char *path, int size, unsigned char **p_atlas, 
+int *p_width, int *p_height, float *p_ratio) {
+	FILE *file = fopen(path, "rb");
+	if (!file) return false;
+
+	// Checks that the atlas was generated the same way.
+	GlyphsCacheHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, "ASDF", 4) ||
+		header.version != GLYPHS_CACHE_VERSION || header.size != size || 
+		header.spread != GLYPHS_SDF_SPREAD || header.width <= 0 || header.height <= 0 ||
+		header.width%16 || header.height%10 || !(header.ratio > 0.0f)) {
+		fprintf(stderr, "[ARGUS]: warning: the glyphs cache %s is outdated. It will be generated again.\n", path);
+		fclose(file);
+		return false;
+	}
+
+	// Reads the distances.
+	const size_t len = (size_t)header.width*header.height;
+	unsigned char *atlas = malloc(len);
+	if (!atlas || fread(atlas, 1, len, file) != len) {
+		fprintf(stderr, "[ARGUS]: warning: unable to read the glyphs cache %s. It will be generated again.\n", path);
+		free(atlas);
+		fclose(file);
+		return false;
+	}
+	fclose(file);
+	*p_atlas = atlas;
+	*p_width = header.width;
+	*p_height = header.height;
+	*p_ratio = header.ratio;
+	return true;
+}
+
+/// @brief Saves a distance field atlas on disk.
+/// @param path The path of the cache file.
+/// @param size The font size the atlas was generated with.
+/// @param atlas The atlas to save.
+/// @param width The width of the atlas.
+/// @param height The height of the atlas.
+/// @param ratio The glyph ratio of the font (w/h).
+static void glyphs_save_atlas(const char *path, int size, const unsigned char *atlas, 
+int width, int height, float ratio) {
+	const GlyphsCacheHeader header = {
+		{'A','S','D','F'}, GLYPHS_CACHE_VERSION, size, GLYPHS_SDF_SPREAD, width, height, ratio
+	};
+	FILE *file = fopen(path, "wb");
+	const size_t len = (size_t)width*height;
+	if (!file || fwrite(&header, sizeof(header), 1, file) != 1 || fwrite(atlas, 1, len, file) != len) {
+		fprintf(stderr, "[ARGUS]: warning: unable to write the glyphs cache %s.\n", path);
+		if (file) fclose(file);
+		remove(path);
+		return;
+	}
+	fclose(file);
+}
+
+/// @brief Creates a glyphs set from a ttf file.
+/// @param size Font size used to generate the glyphs images.
+/// @param cache_path The file where the atlas is cached between two runs, or NULL to always generate it.
+/// @return The generated glyphs sets. 
+/// @note The atlas stores the signed distance to the edge of the glyphs, so that the text stays
+/// sharp at any scale. Generating it is slow, so with a cache SDL_ttf is only used on the first run.
+Glyphs *glyphs_create(int size, const char *cache_path) {
+
+	// Malloc the glyphs set structure and its empty layout cache.
+	Glyphs *glyphs = malloc(sizeof(Glyphs));
+	if (!glyphs) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc the glyphs structure !\n");
+		return NULL;
+	}
+	glyphs->layouts = calloc(GLYPHS_LAYOUT_CACHE, sizeof(GlyphsLayout));
+	if (!glyphs->layouts) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc the layout cache of the glyphs !\n");
+		free(glyphs);
+		return NULL;
+	}
+
+	// Loads the atlas from the cache, or generates it.
+	unsigned char *atlas = NULL;
+	int width = 0;
+	int height = 0;
+	if (!cache_path || !glyphs_load_atlas(cache_path, size, &atlas, &width, &height, &glyphs->ratio)) {
+		if (!glyphs_render_atlas(size, &atlas, &width, &height, &glyphs->ratio)) {
+			fprintf(stderr, "[ARGUS]: error: unable to generate the glyphs atlas !\n");
+			free(glyphs->layouts);
+			free(glyphs);
+			return NULL;
+		}
+		if (cache_path) glyphs_save_atlas(cache_path, size, atlas, width, height, glyphs->ratio);
+	}
+
+	// Generates the texture. The distances are interpolated, so it is filtered linearly.
+	GLint alignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glGenTextures(1, &glyphs->texture_id);
 	glBindTexture(GL_TEXTURE_2D, glyphs->texture_id);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, surface->w, surface->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, atlas);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glBindTexture(GL_TEXTURE_2D, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+	free(atlas);
 	return glyphs;
 }
 
@@ -158,197 +405,117 @@ Glyphs *glyphs_create(int size) {
 /// @note After freeing, the pointer *p_glyphs is set to NULL to avoid double-free.
 void glyphs_free(Glyphs **p_glyphs) {
 	Glyphs *glyphs = *p_glyphs;
-	if (!p_glyphs) return;
+	if (!glyphs) return;
 	glDeleteTextures(1, &glyphs->texture_id);
+	free(glyphs->layouts);
 	free(glyphs);
 	*p_glyphs = NULL;
 }
 
-/// @brief Binds the texture of the glyphs.
-/// @param glyphs The glyphs to bind.
-void glyphs_bind(Glyphs *glyphs) {
-	if (glyphs) glBindTexture(GL_TEXTURE_2D, glyphs->texture_id);
-	else glBindTexture(GL_TEXTURE_2D, 0);
-}
-
-/// @brief Used to get the vertices of a glyph.
-/// @param vertices Buffer to stores the vertices.
-/// @param offset Offset in the buffer.
-/// @param id id of the character from which to get the vertices.
-/// @note vertices is supposed to be at least (offset + 12) * sizeof(float) bytes long.
-void glyphs_get_vertices(float *vertices, int offset, int id) {
-	float x = (id%16)*0.0625f;
-	float y = (id/16)*0.1f;
-
-	// Upper-left triangle.
-	vertices[offset]	= x;
-	vertices[offset+1]	= y;
-	vertices[offset+2]	= x+0.0625f;
-	vertices[offset+3]	= y+0.1f;
-	vertices[offset+4]	= x;
-	vertices[offset+5]	= y+0.1f;
-
-	// Lower-right triangle.
-	vertices[offset+6]	= x;
-	vertices[offset+7]	= y;
-	vertices[offset+8]	= x+0.0625f;
-	vertices[offset+9]	= y;
-	vertices[offset+10]	= x+0.0625f;
-	vertices[offset+11]	= y+0.1f;
-
-}
-
-/// @brief Creates buffers containing data to render a text in a given rect.
+/// @brief Calculates the rect of the first character of a text laid out in a given rect.
 /// @param glyphs The glyphs set to use.
-/// @param p_rect Pointer on the rect that will contains the text.
-/// @param text The text to render.
-/// @return false if there was an error.
-bool glyphs_generate_text_buffers(Glyphs *glyphs, Rect *p_rect, const char *text, 
-float screen_ratio, float **vertices, float **textures, int *n) {
-
-	// Initialize the rects.
-	Rect rect = *p_rect;
+/// @param rect The rect that will contains the text.
+/// @param n The number of characters of the text.
+/// @param screen_ratio The ratio of the window (w/h).
+/// @param vertical true if the text is laid out vertically, from the bottom to the top.
+/// @return The rect of the first character. The next ones are on its right, or above it if vertical.
+static Rect glyphs_first_rect(Glyphs *glyphs, Rect rect, int n, float screen_ratio, bool vertical) {
 	Rect glyph_rect = RECT_INIT;
+
+	// Calculates the size and the position of the glyphs of a vertical text.
+	if (vertical) {
+		glyph_rect.h = rect.w*glyphs->ratio*screen_ratio;
+		glyph_rect.w = rect.w;
+		const float exceeding = n*glyph_rect.h/rect.h;
+		if (exceeding > 1.0f) {
+			glyph_rect.w /= exceeding;
+			glyph_rect.h /= exceeding;
+			glyph_rect.x = rect.x + 0.5f*(rect.w-glyph_rect.w);
+			glyph_rect.y = rect.y;
+		} else {
+			glyph_rect.x = rect.x;
+			glyph_rect.y = rect.y + 0.5f*(rect.h-n*glyph_rect.h);
+		}
+		glyph_rect.y += (n-1)*glyph_rect.h; 
+		return glyph_rect;
+	}
+
+	// Calculates the size and the position of the glyphs of a horizontal text.
 	glyph_rect.h = rect.h;
 	glyph_rect.w = rect.h*glyphs->ratio/screen_ratio;
-
-	// Calculates the size and the position of the glyphs.
-	*n = utf8_len(text);
-	const float exceeding = (*n)*glyph_rect.w/rect.w;
+	const float exceeding = n*glyph_rect.w/rect.w;
 	if (exceeding > 1.0f) {
 		glyph_rect.w /= exceeding;
 		glyph_rect.h /= exceeding;
 		glyph_rect.x = rect.x;
 		glyph_rect.y = rect.y + 0.5f*(rect.h-glyph_rect.h);
 	} else {
-		glyph_rect.x = rect.x + 0.5f*(rect.w-(*n)*glyph_rect.w);
+		glyph_rect.x = rect.x + 0.5f*(rect.w-n*glyph_rect.w);
 		glyph_rect.y = rect.y;
 	}
-
-	// Malloc for the vertices buffers.
-	*vertices = malloc(12*(*n)*sizeof(float));
-	if (!*vertices) {
-		fprintf(stderr, "[ARGUS]: error: unable to malloc a buffer for the vertices of a text VAO !\n");
-		return false;
-	}
-	*textures = malloc(12*(*n)*sizeof(float));
-	if (!*textures) {
-		fprintf(stderr, "[ARGUS]: error: unable to malloc a buffer for the texture vertices of a text VAO !\n");
-		free(*vertices);
-		return false;
-	}
-
-	// For each character, adds it to the vertices lists.
-	int c = 0;
-	int i = 0;
-	while ((c = utf8_iterate(&text))) {
-		const int id = id_from_char(c)&0x000000FF;
-
-		// Upper-left triangle.
-		(*vertices)[12*i]		= glyph_rect.x;
-		(*vertices)[12*i+1]		= glyph_rect.y;
-		(*vertices)[12*i+2]		= glyph_rect.x + glyph_rect.w;
-		(*vertices)[12*i+3]		= glyph_rect.y + glyph_rect.h;
-		(*vertices)[12*i+4]		= glyph_rect.x;
-		(*vertices)[12*i+5]		= glyph_rect.y + glyph_rect.h;
-
-		// Lower-right triangle.
-		(*vertices)[12*i+6]		= glyph_rect.x;
-		(*vertices)[12*i+7]		= glyph_rect.y;
-		(*vertices)[12*i+8]		= glyph_rect.x + glyph_rect.w;
-		(*vertices)[12*i+9]		= glyph_rect.y;
-		(*vertices)[12*i+10]	= glyph_rect.x + glyph_rect.w;
-		(*vertices)[12*i+11]	= glyph_rect.y + glyph_rect.h;
-
-		// Adds the texture vertices.
-		glyphs_get_vertices(*textures, 12*i, id);
-		glyph_rect.x += glyph_rect.w;
-		++i;
-	}
-	return true;
+	return glyph_rect;
 }
 
-/// @brief Creates buffers containing data to render a vertical text in a given rect.
+/// @brief Writes the rect and the atlas cell of each character of a text laid out in a given rect.
 /// @param glyphs The glyphs set to use.
-/// @param p_rect Pointer on the rect that will contains the text.
+/// @param rect The rect that will contains the text.
 /// @param text The text to render.
-/// @return false if there was an error.
-bool glyphs_generate_vertical_text_buffers(Glyphs *glyphs, Rect *p_rect, const char *text, 
-float screen_ratio, float **vertices, float **textures, int *n) {
-
-	// Initialize the rects.
-	Rect rect = *p_rect;
-	Rect glyph_rect = RECT_INIT;
-	glyph_rect.h = rect.w*glyphs->ratio*screen_ratio;
-	glyph_rect.w = rect.w;
-
-	// Calculates the size and the position of the glyphs.
-	*n = utf8_len(text);
-	const float exceeding = (*n)*glyph_rect.h/rect.h;
-	if (exceeding > 1.0f) {
-		glyph_rect.w /= exceeding;
-		glyph_rect.h /= exceeding;
-		glyph_rect.x = rect.x + 0.5f*(rect.w-glyph_rect.w);
-		glyph_rect.y = rect.y;
-	} else {
-		glyph_rect.x = rect.x;
-		glyph_rect.y = rect.y + 0.5f*(rect.h-(*n)*glyph_rect.h);
-	}
-	glyph_rect.y += ((*n)-1)*glyph_rect.h; 
-
-	// Malloc for the vertices buffers.
-	*vertices = malloc(12*(*n)*sizeof(float));
-	if (!vertices) {
-		fprintf(stderr, "[ARGUS]: error: unable to malloc a buffer for the vertices of a text VAO !\n");
-		return false;
-	}
-	*textures = malloc(12*(*n)*sizeof(float));
-	if (!textures) {
-		fprintf(stderr, "[ARGUS]: error: unable to malloc a buffer for the texture vertices of a text VAO !\n");
-		free(vertices);
-		return false;
-	}
-
-	// For each character, adds it to the vertices lists.
+/// @param screen_ratio The ratio of the window (w/h).
+/// @param vertical true to lay the text out vertically, from the bottom to the top.
+/// @param rects The buffer where to write the rects (x, y, w, h). Must be at least 4*utf8_len(text) floats long.
+/// @param cells The buffer where to write the atlas cells. Must be at least utf8_len(text) floats long.
+/// @return The number of characters written.
+/// @note 5 floats per character are enough, the quad and its texture coordinates being rebuilt by the glyph shader.
+int glyphs_write_instances(Glyphs *glyphs, Rect rect, const char *text, 
+float screen_ratio, bool vertical, float *rects, float *cells) {
+	Rect glyph_rect = glyphs_first_rect(glyphs, rect, utf8_len(text), screen_ratio, vertical);
 	int c = 0;
 	int i = 0;
 	while ((c = utf8_iterate(&text))) {
-		const int id = id_from_char(c)&0x000000FF;
-
-		// Upper-left triangle.
-		(*vertices)[12*i]		= glyph_rect.x;
-		(*vertices)[12*i+1]		= glyph_rect.y + glyph_rect.h;
-		(*vertices)[12*i+2]		= glyph_rect.x + glyph_rect.w;
-		(*vertices)[12*i+3]		= glyph_rect.y;
-		(*vertices)[12*i+4]		= glyph_rect.x + glyph_rect.w;
-		(*vertices)[12*i+5]		= glyph_rect.y + glyph_rect.h;
-
-		// Lower-right triangle.
-		(*vertices)[12*i+6]		= glyph_rect.x;
-		(*vertices)[12*i+7]		= glyph_rect.y + glyph_rect.h;
-		(*vertices)[12*i+8]		= glyph_rect.x;
-		(*vertices)[12*i+9]		= glyph_rect.y;
-		(*vertices)[12*i+10]	= glyph_rect.x + glyph_rect.w;
-		(*vertices)[12*i+11]	= glyph_rect.y;
-
-		// Adds the texture vertices.
-		glyphs_get_vertices(*textures, 12*i, id);
-		glyph_rect.y -= glyph_rect.h;
+		rects[4*i]		= glyph_rect.x;
+		rects[4*i+1]	= glyph_rect.y;
+		rects[4*i+2]	= glyph_rect.w;
+		rects[4*i+3]	= glyph_rect.h;
+		cells[i] = id_from_char(c)&0x000000FF;
+		if (vertical) glyph_rect.y -= glyph_rect.h;
+		else glyph_rect.x += glyph_rect.w;
 		++i;
 	}
-	return true;
+	return i;
 }
-	
-/// @brief Generates a VAO from buffers to render text.
-/// @param vertices Vertices buffer. It's size must be at least 12*nb_char*sizeof(float).
-/// @param textures Textures buffer. It's size must be at least 12*nb_char*sizeof(float).
-/// @param nb_char The number of characters in the buffers.
-/// @return The generated VAO. 
-VAO *glyphs_generate_text_vao(float *vertices, float *textures, int nb_char) {
-	void *data[2] = {vertices, textures};
-	int sizes[2] = {2,2};
-	int gl_types[2] = {GL_FLOAT, GL_FLOAT};
-	VAO *vao = vao_create(data, sizes, gl_types, 6*nb_char, 2);
-	if (!vao) fprintf(stderr, "[ARGUS]: error: unable to create a VAO for a text buffer !\n");	
-	return vao;
+
+/// @brief Gets the layout of a short text in a rect of a given size, from the cache if possible.
+/// @param glyphs The glyphs set to use.
+/// @param w The width of the rect.
+/// @param h The height of the rect.
+/// @param text The text to render. Must be shorter than GLYPHS_LAYOUT_TEXT bytes.
+/// @param screen_ratio The ratio of the window (w/h).
+/// @param vertical true to lay the text out vertically.
+/// @return The layout, relative to the origin of the rect, or NULL if the text is too long.
+/// @note The layout is only valid until the next call, which may replace it in the cache.
+/// @note A hit costs a hash of the text, with no allocation and no layout.
+const GlyphsLayout *glyphs_layout(Glyphs *glyphs, float w, float h, const char *text, float screen_ratio, bool vertical) {
+	const size_t len = strlen(text);
+	if (len >= GLYPHS_LAYOUT_TEXT) return NULL;
+
+	// Hashes the key with FNV-1a to find its slot.
+	uint32_t hash = 2166136261u;
+	const float sizes[3] = {w, h, screen_ratio};
+	const unsigned char *bytes = (const unsigned char*)sizes;
+	for (size_t i = 0; i < sizeof(sizes); ++i) hash = (hash ^ bytes[i]) * 16777619u;
+	for (size_t i = 0; i < len; ++i) hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+	hash = (hash ^ vertical) * 16777619u;
+	GlyphsLayout *layout = glyphs->layouts + hash%GLYPHS_LAYOUT_CACHE;
+	if (layout->w == w && layout->h == h && layout->screen_ratio == screen_ratio && 
+		layout->vertical == vertical && !strcmp(layout->text, text)) return layout;
+
+	// Lays the text out on a miss, replacing the previous layout of the slot.
+	const Rect rect = {0.0f, 0.0f, w, h};
+	memcpy(layout->text, text, len+1);
+	layout->w = w;
+	layout->h = h;
+	layout->screen_ratio = screen_ratio;
+	layout->vertical = vertical;
+	layout->n = glyphs_write_instances(glyphs, rect, text, screen_ratio, vertical, layout->rects, layout->cells);
+	return layout;
 }
@@ -9,30 +9,50 @@
 
 
 
+// Distance in pixels from the edge of a glyph at which its distance field saturates.
+#define GLYPHS_SDF_SPREAD 8
+
+// Distance used for the pixels without any feature in the distance transforms.
+#define GLYPHS_SDF_FAR 1e20f
+
+// Max length in bytes of the texts whose layout is cached, with the final 0.
+#define GLYPHS_LAYOUT_TEXT 16
+
+// Number of layouts kept in the cache of a glyphs set.
+#define GLYPHS_LAYOUT_CACHE 256
+
+
+/// @struct GlyphsLayout
+/// @brief The glyphs of a short text laid out in a rect, relative to the rect origin.
+typedef struct {
+	char text[GLYPHS_LAYOUT_TEXT];	///< The text, empty if the layout is unused.
+	float w;				///< The width of the rect.
+	float h;				///< The height of the rect.
+	float screen_ratio;		///< The ratio of the window (w/h).
+	bool vertical;			///< true if the text is laid out vertically.
+	int n;					///< The number of characters of the text.
+	float rects[4*(GLYPHS_LAYOUT_TEXT-1)];	///< The rect (x, y, w, h) of each character.
+	float cells[GLYPHS_LAYOUT_TEXT-1];		///< The atlas cell of each character.
+} GlyphsLayout;
+
 /// @struct Glyphs
 /// @brief Used to load and use a font as an atlas of textures.
 typedef struct {
-	GLuint texture_id;	///< OpenGL texture id.
+	GLuint texture_id;	///< OpenGL texture id of the distance field atlas.
 	float ratio;		///< The glyph ratio of the loaded font (w/h).
+	GlyphsLayout *layouts;	///< Cache of the layouts of short texts, indexed by the hash of their key.
 } Glyphs;
 
 
 // Creates a glyphs set from a ttf file.
-Glyphs *glyphs_create(int size);
+Glyphs *glyphs_create(int size, const char *cache_path);
 
 // FrFrees the memory allocated for a Glyphs.
 void glyphs_free(Glyphs **p_glyphs);
 
-// Binds the texture of the glyphs.
-void glyphs_bind(Glyphs *glyphs);
-
-// Creates buffers containing data to render a text in a given rect.
-bool glyphs_generate_text_buffers(Glyphs *glyphs, Rect *p_rect, 
-const char *text, float screen_ratio, float **vertices, float **textures, int *n);
-
-// Creates buffers containing data to render a vertical text in a given rect.
-bool glyphs_generate_vertical_text_buffers(Glyphs *glyphs, Rect *p_rect,  
-const char *text, float screen_ratio, float **vertices, float **textures, int *n);
+// Writes the rect and the atlas cell of each character of a text laid out in a given rect.
+int glyphs_write_instances(Glyphs *glyphs, Rect rect, const char *text, 
+float screen_ratio, bool vertical, float *rects, float *cells);
 
-// Generates a VAO from buffers to render text.
-VAO *glyphs_generate_text_vao(float *vertices, float *textures, int nb_char);
+// Gets the layout of a short text in a rect of a given size, from the cache if possible.
+const GlyphsLayout *glyphs_layout(Glyphs *glyphs, float w, float h, const char *text, float screen_ratio, bool vertical);
@@ -21,6 +21,9 @@ void save_screnshot(void *args) {
 	const char *title = graph->title;
 	if (!title || !strlen(title)) title = "graph";
 	screenshot_graph(graph, glyphs, title);
+
+	// The screenshot prepared the curves for its own size, so they must be prepared again.
+	graph->grid_valid = false;
 }
 
 
@@ -48,9 +51,18 @@ Graph *graph_create(Rect rect) {
 	graph->text_color = COLOR_BLACK;
 	graph->background_vao = NULL;
 	graph->grid_vao = NULL;
-	graph->title_vao = NULL;
+	graph->titles = NULL;
+	graph->texts = NULL;
 	graph->save = NULL;
 	graph->title = NULL;
+	atomic_init(&graph->dirty, false);
+	graph->limits = RECT_INIT;
+	graph->grid_valid = false;
+	graph->layer = NULL;
+	graph->data_first = NULL;
+	graph->data_count = NULL;
+	graph->data_colors = NULL;
+	graph->data_cap = 0;
 
 	// Creates the curves vector.
 	graph->curves = curves_create();
@@ -70,13 +82,18 @@ void graph_free(Graph **p_graph) {
 	if (!graph) return;
 	curves_free(&graph->curves);
 	vao_free(&graph->background_vao);
-	vao_free(&graph->title_vao);
+	textbatch_free(&graph->titles);
+	textbatch_free(&graph->texts);
 	vao_free(&graph->grid_vao);
 	free(graph->x_axis.title);
 	free(graph->y_axis.title);
 	axis_reset_graphics(&graph->x_axis);
 	axis_reset_graphics(&graph->y_axis);
 	imagebutton_free(&graph->save);
+	layer_free(&graph->layer);
+	free(graph->data_first);
+	free(graph->data_count);
+	free(graph->data_colors);
 	free(graph->title);
 	free(graph);
 	*p_graph = NULL;
@@ -105,25 +122,23 @@ bool graph_prepare_static(Graph *graph, Glyphs *glyphs, int window_width, int wi
 		graph->rect.w-2*dx, graph->rect.h-text_height/window_height-2*dy
 	};
 
-	// Creates the text VAO for the graph title.
+	// Creates the text batches. The titles are laid out once, and the texts are made of them and of the labels.
+	if (!graph->titles) graph->titles = textbatch_create();
+	if (!graph->texts) graph->texts = textbatch_create();
+	if (!graph->titles || !graph->texts) {
+		fprintf(stderr, "[ARGUS]: error: unable to create the text batches of a graph!\n");
+		return false;
+	}
+	textbatch_clear(graph->titles);
+
+	// Adds the characters of the graph title.
 	if (!graph->title || !strlen(graph->title)) {
 		graph_rect.y = graph->rect.y+dy;
 		graph_rect.h = graph->rect.h-2*dy;
-		graph->title_vao = NULL;
-	} else {
-		int n;
-		float *vertices;
-		float *textures;
-		if (!glyphs_generate_text_buffers(glyphs, &title_rect, graph->title, 
-			(float)window_width/window_height, &vertices, &textures, &n)) {
-			fprintf(stderr, "[ARGUS]: error: unable to create buffer to store the data of the title of a graph!\n");
-			return false;
-		}
-		graph->title_vao = glyphs_generate_text_vao(vertices, textures, n);
-		if (!graph->title_vao) {
-			fprintf(stderr, "[ARGUS]: error: unable to create the VAO for the title of a graph!\n");
-			return false;
-		}
+	} else if (!textbatch_add(graph->titles, glyphs, title_rect, graph->title, 
+		(float)window_width/window_height, false, TEXTCOLOR_TITLE)) {
+		fprintf(stderr, "[ARGUS]: error: unable to create buffer to store the data of the title of a graph!\n");
+		return false;
 	}
 
 	// Calculate the rects of the axis.
@@ -148,12 +163,12 @@ bool graph_prepare_static(Graph *graph, Glyphs *glyphs, int window_width, int wi
 		y_axis_rect.w, x_axis_rect.h 
 	};
 
-	// Prepares the axis VAOs.
-	if (!axis_prepare_x_title(&graph->x_axis, glyphs, &x_axis_rect, window_width, window_height)) {
+	// Adds the characters of the axis titles.
+	if (!axis_prepare_x_title(&graph->x_axis, glyphs, graph->titles, &x_axis_rect, window_width, window_height)) {
 		fprintf(stderr, "[ARGUS]: error: unable to prepare the x axis title of a graph!\n");
 		return false;
 	}
-	if (!axis_prepare_y_title(&graph->y_axis, glyphs, &y_axis_rect, window_width, window_height)) {
+	if (!axis_prepare_y_title(&graph->y_axis, glyphs, graph->titles, &y_axis_rect, window_width, window_height)) {
 		fprintf(stderr, "[ARGUS]: error: unable to prepare the y axis title of a graph!\n");
 		return false;
 	}
@@ -181,6 +196,9 @@ bool graph_prepare_static(Graph *graph, Glyphs *glyphs, int window_width, int wi
 		return false;
 	}
 
+	// The grid and the curves depend on the layout, so they must be fully prepared again.
+	graph->grid_valid = false;
+
 	// Initializes the vertices for the background part.
 	float vertices[24] = {
 		graph->rect.x,graph->rect.y, 
@@ -221,14 +239,19 @@ bool graph_prepare_static(Graph *graph, Glyphs *glyphs, int window_width, int wi
 		fprintf(stderr, "[ARGUS]: error: unable to create the VAO for the background of a graph!\n");
 		return false;
 	}
+
+	// Creates the cache of the static components. They are drawn directly if it can't be created.
+	layer_free(&graph->layer);
+	graph->layer = layer_create(graph->rect, window_width, window_height);
+	if (!graph->layer) {
+		fprintf(stderr, "[ARGUS]: warning: unable to create the static layer of a graph. It will be drawn directly.\n");
+	}
 	return true;
 }
 
-/// @brief Prepares the dynamic graphical components of a graph.
-/// @param graph The graph to prepare.
-/// @note This has to be called before each graph_render call.
-/// @return false if there was an error.
-bool graph_prepare_dynamic(Graph *graph, Glyphs *glyphs, int window_width, int window_height) {
+/// @brief Adapts the limits of the axes of a graph to its curves.
+/// @param graph The graph to adapt.
+static void graph_adapt_axes(Graph *graph) {
 
 	// Adapts the x axis if needed.
 	if ((graph->x_axis.auto_adapt == ADAPTMODE_AUTO_EXTEND ||
@@ -236,7 +259,7 @@ bool graph_prepare_dynamic(Graph *graph, Glyphs *glyphs, int window_width, int w
 		curves_size(graph->curves)) {
 		if (graph->x_axis.auto_adapt == ADAPTMODE_AUTO_FIT) {
 			graph->x_axis.min = FLT_MAX;
-			graph->x_axis.max = FLT_MIN;
+			graph->x_axis.max = -FLT_MAX;
 		}
 		for (size_t i = 0; i < curves_size(graph->curves); ++i) {
 			const Curve *curve = graph->curves->data[i];
@@ -249,7 +272,7 @@ bool graph_prepare_dynamic(Graph *graph, Glyphs *glyphs, int window_width, int w
 		for (size_t i = 0; i < curves_size(graph->curves); ++i) {
 			const Curve *curve = graph->curves->data[i];
 			if (!curve->to_render || !curve->x_val->size) continue;
-			float new_x = ringbuffer_at(curve->x_val, curve->x_val->size-1);	
+			float new_x = ringbuffer_back(curve->x_val);
 			if (new_x < graph->x_axis.min) {
 				float dx = new_x-graph->x_axis.min; 
 				graph->x_axis.min += dx;
@@ -269,7 +292,7 @@ bool graph_prepare_dynamic(Graph *graph, Glyphs *glyphs, int window_width, int w
 		curves_size(graph->curves)) {
 		if (graph->y_axis.auto_adapt == ADAPTMODE_AUTO_FIT) {
 			graph->y_axis.min = FLT_MAX;
-			graph->y_axis.max = FLT_MIN;
+			graph->y_axis.max = -FLT_MAX;
 		}
 		for (size_t i = 0; i < curves_size(graph->curves); ++i) {
 			const Curve *curve = graph->curves->data[i];
@@ -282,7 +305,7 @@ bool graph_prepare_dynamic(Graph *graph, Glyphs *glyphs, int window_width, int w
 		for (size_t i = 0; i < curves_size(graph->curves); ++i) {
 			const Curve *curve = graph->curves->data[i];
 			if (!curve->to_render || !curve->y_val->size) continue;
-			float new_y = ringbuffer_at(curve->y_val, curve->y_val->size-1);	
+			float new_y = ringbuffer_back(curve->y_val);
 			if (new_y < graph->y_axis.min) {
 				float dy = new_y-graph->y_axis.min; 
 				graph->y_axis.min += dy;
@@ -305,47 +328,155 @@ bool graph_prepare_dynamic(Graph *graph, Glyphs *glyphs, int window_width, int w
 		graph->y_axis.min = 0.0f;
 		graph->y_axis.max = 1.0f;
 	}
+}
 
-	// Prepares the grid VAO.
-	if (!grid_prepare_dynamic(graph, glyphs, &graph->grid_rect, window_width, window_height)) {
-		fprintf(stderr, "[ARGUS]: error: unable to create the grid of a graph!\n");
+/// @brief Grows the buffers of the ranges of the line curves of a graph, up to two ranges per curve.
+/// @param graph The graph to modify.
+/// @return false if there was an error.
+static bool graph_reserve_ranges(Graph *graph) {
+	const size_t cap = 2*curves_size(graph->curves);
+	if (cap <= graph->data_cap) return true;
+	GLint *first = realloc(graph->data_first, cap*sizeof(GLint));
+	if (first) graph->data_first = first;
+	GLsizei *count = realloc(graph->data_count, cap*sizeof(GLsizei));
+	if (count) graph->data_count = count;
+	float *colors = realloc(graph->data_colors, 3*cap*sizeof(float));
+	if (colors) graph->data_colors = colors;
+	if (!first || !count || !colors) {
+		fprintf(stderr, "[ARGUS]: error: unable to realloc the ranges of the curves of a graph!\n");
 		return false;
 	}
+	graph->data_cap = cap;
+	return true;
+}
+
+/// @brief Prepares the dynamic graphical components of a graph.
+/// @param graph The graph to prepare.
+/// @note This has to be called before each graph_render call.
+/// @note Only the components that changed are prepared: the grid and the labels when the 
+/// axis limits changed, and the curves whose data changed, or that depend on the limits.
+/// Everything is prepared after graph_prepare_static.
+/// @return false if there was an error.
+bool graph_prepare_dynamic(Graph *graph, Glyphs *glyphs, int window_width, int window_height) {
+	graph_adapt_axes(graph);
+	const Rect limits = {graph->x_axis.min, graph->y_axis.min, graph->x_axis.max, graph->y_axis.max};
+	const bool all = !graph->grid_valid;
+	const bool moved = all || limits.x != graph->limits.x || limits.y != graph->limits.y || 
+		limits.w != graph->limits.w || limits.h != graph->limits.h;
+
+	// Prepares the grid VAO and the labels if the limits changed, then gathers all the texts.
+	if (moved) {
+		if (!grid_prepare_dynamic(graph, glyphs, &graph->grid_rect, window_width, window_height)) {
+			fprintf(stderr, "[ARGUS]: error: unable to create the grid of a graph!\n");
+			return false;
+		}
+		textbatch_clear(graph->texts);
+		if (!textbatch_append(graph->texts, graph->titles) || 
+			!textbatch_append(graph->texts, graph->x_axis.labels.glyphs) ||
+			!textbatch_append(graph->texts, graph->y_axis.labels.glyphs) ||
+			!textbatch_upload(graph->texts)) {
+			fprintf(stderr, "[ARGUS]: error: unable to prepare the texts of a graph!\n");
+			return false;
+		}
+		graph->limits = limits;
+		graph->grid_valid = true;
+		if (graph->layer) graph->layer->valid = false;
+	}
 
-	// Prepares the curves VAOs.
+	// Prepares the vertices of the curves that changed. The decimated ones depend on the limits too.
 	for (size_t i = 0; i < curves_size(graph->curves); ++i) {
-		if (!curve_prepare_dynamic(graph->curves->data[i], &graph->x_axis, &graph->y_axis, graph->grid_rect)) {
+		Curve *curve = graph->curves->data[i];
+		if (!all && !curve->to_render && !(moved && curve->decimated)) continue;
+		curve->to_render = false;
+		if (!curve_prepare_dynamic(curve, &graph->x_axis, &graph->y_axis, graph->grid_rect, window_width)) {
 			fprintf(stderr, "[ARGUS]: error: unable to create the vao of a curve!\n");
 			return false;
 		}
 	}
-	return true;
+	return graph_reserve_ranges(graph);
 }
 
 /// @brief Frees the graphics components a the end of the render.
 /// @param graph The graph to reset.
 void graph_reset_graphics(Graph *graph) {
+	for (size_t i = 0; i < curves_size(graph->curves); ++i) {
+		curve_reset_graphics(graph->curves->data[i]);
+	}
 	axis_reset_graphics(&graph->x_axis);
 	axis_reset_graphics(&graph->y_axis);
 	vao_free(&graph->grid_vao);
 	vao_free(&graph->background_vao);
-	vao_free(&graph->title_vao);
+	textbatch_free(&graph->titles);
+	textbatch_free(&graph->texts);
+	layer_free(&graph->layer);
+	graph->grid_valid = false;
+}
+
+/// @brief Renders the static components of the graph: background, texts and grid.
+/// @param graph The graph to render.
+/// @param glyphs The glyphs set to use to render texts.
+static void graph_render_static(Graph *graph, Glyphs *glyphs) {
+	const Color colors[TEXTCOLOR_SIZE] = {
+		[TEXTCOLOR_TEXT] = graph->text_color,
+		[TEXTCOLOR_TITLE] = graph->title_color
+	};
+	render_set_depth(RENDERDEPTH_BACKGROUND);
+	render_shape(graph->background_vao, 1.0f);
+	render_set_depth(RENDERDEPTH_TEXT);
+	render_text_batch(glyphs, graph->texts, colors, TEXTCOLOR_SIZE);
+	render_set_depth(RENDERDEPTH_GRID);
+	render_curve(graph->grid_vao, graph->text_color, false);
 }
 
 /// @brief Renders the graph.
 /// @param graph The graph to render.
 /// @param glyphs The glyphs set to use to render texts.
+/// @note The static components are drawn into the layer of the graph only when they changed, 
+/// then the layer is drawn as a single quad under the curves.
+/// @note Between render_begin and render_end, the draws are only recorded with their depth,
+/// so that the draws of all the graphs are grouped by shader.
+/// @note The line curves are stored in the vertex arena, so all the ones between two scatter
+/// curves are drawn by a single multi draw.
 void graph_render(Graph *graph, Glyphs *glyphs) {
-	render_shape(graph->background_vao, 1.0f);
-	render_text(glyphs, graph->title_vao, graph->title_color);
-	render_text(glyphs, graph->x_axis.title_vao, graph->text_color);
-	render_text(glyphs, graph->y_axis.title_vao, graph->text_color);
-	render_text(glyphs, graph->x_axis.axis_vao, graph->text_color);
-	render_text(glyphs, graph->y_axis.axis_vao, graph->text_color);
+	const Rect limits = {graph->x_axis.min, graph->y_axis.min, graph->x_axis.max, graph->y_axis.max};
+	if (graph->layer) {
+		if (!graph->layer->valid) {
+			layer_begin(graph->layer);
+				graph_render_static(graph, glyphs);
+			layer_end(graph->layer);
+		}
+		render_set_depth(RENDERDEPTH_BACKGROUND);
+		layer_render(graph->layer);
+	} else graph_render_static(graph, glyphs);
+
+	// Gathers the ranges of the consecutive line curves to draw them in a single call.
+	size_t first = 0;
+	size_t n = 0;
+	int depth = RENDERDEPTH_DATA;
 	for (size_t i = 0; i < curves_size(graph->curves); ++i) {
 		Curve *curve = graph->curves->data[i];
-		render_curve(curve->curve_vao, curve->color, true);
+		if (curve->mode == DRAW_SCATTER) {
+			render_set_depth(depth);
+			render_data_ranges(graph->data_first+first, graph->data_count+first, graph->data_colors+3*first,
+				n-first, limits, graph->grid_rect);
+			first = n;
+			render_set_depth(RENDERDEPTH_DATA+i);
+			render_data_scatter(curve->scatter_vao, curve->color, limits, graph->grid_rect, 
+				curve->marker_size, curve->x_val ? curve->x_val->size : 0);
+			depth = RENDERDEPTH_DATA+i+1;
+			continue;
+		}
+		for (int j = 0; j < curve->ranges && n < graph->data_cap; ++j, ++n) {
+			graph->data_first[n] = curve->range_first[j];
+			graph->data_count[n] = curve->range_count[j];
+			graph->data_colors[3*n] = curve->color.r;
+			graph->data_colors[3*n+1] = curve->color.g;
+			graph->data_colors[3*n+2] = curve->color.b;
+		}
 	}
-	render_curve(graph->grid_vao, graph->text_color, false);
+	render_set_depth(depth);
+	render_data_ranges(graph->data_first+first, graph->data_count+first, graph->data_colors+3*first,
+		n-first, limits, graph->grid_rect);
+	render_set_depth(RENDERDEPTH_OVERLAY);
 	imagebutton_render(graph->save);
 }
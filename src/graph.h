@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdatomic.h>
 
 #include "vao.h"
 #include "curves.h"
@@ -9,6 +10,8 @@
 #include "structs.h"
 #include "axis.h"
 #include "button.h"
+#include "layer.h"
+#include "text_batch.h"
 
 
 
@@ -26,9 +29,18 @@ typedef struct {
 	Curves *curves;			///< List of the curves to draw.
 	VAO *grid_vao;			///< VAO for the grid of the graph.
 	VAO *background_vao;	///< VAO for the background of the graph.
-	VAO *title_vao;			///< VAO for the graph title.
+	TextBatch *titles;		///< The characters of the graph title and of the axis titles.
+	TextBatch *texts;		///< All the characters of the graph, drawn in a single call.
 	ImageButton *save;		///< Button used to save the graph as a png.
 	char *title;			///< The graph title.
+	atomic_bool dirty;		///< true if data was queued into the curves since the last render.
+	Rect limits;			///< The axis limits (x min, y min, x max, y max) the grid and labels were prepared for.
+	bool grid_valid;		///< true if the grid and the axis labels match limits.
+	Layer *layer;			///< Offscreen cache of the static components, or NULL to draw them directly.
+	GLint *data_first;		///< The first vertex of each range of the line curves, in the vertex arena.
+	GLsizei *data_count;	///< The number of vertices of each range of the line curves.
+	float *data_colors;		///< The color (r, g, b) of each range of the line curves.
+	size_t data_cap;		///< The number of ranges the buffers can hold.
 } Graph;
 
 
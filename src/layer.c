@@ -0,0 +1,124 @@
+#include "layer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "render.h"
+
+
+
+/// @brief Creates a layer covering a rect of the window.
+/// @param rect The rect of the window covered by the layer.
+/// @param window_width The width of the window.
+/// @param window_height The height of the window.
+/// @return The created layer, or NULL in case of an error.
+/// @note The texture has one texel per pixel of the rect, so the layer is drawn back without any filtering.
+Layer *layer_create(Rect rect, int window_width, int window_height) {
+	const int width = rect.w*window_width + 0.5f;
+	const int height = rect.h*window_height + 0.5f;
+	if (width <= 0 || height <= 0) {
+		fprintf(stderr, "[ARGUS]: error: (%d,%d) isn't a valid dimension to create a layer!\n", width, height);
+		return NULL;
+	}
+
+	// Malloc the layer.
+	Layer *layer = malloc(sizeof(Layer));
+	if (!layer) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc a Layer!\n");
+		return NULL;
+	}
+	layer->rect = rect;
+	layer->valid = false;
+	layer->texture.width = width;
+	layer->texture.height = height;
+
+	// Creates the FBO and its texture.
+	glGenFramebuffers(1, &layer->fbo);
+	glGenTextures(1, &layer->texture.texture_id);
+	texture_bind(&layer->texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	texture_bind(NULL);
+	GLint old_fbo;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &old_fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, layer->fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, layer->texture.texture_id, 0);
+	const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+	layer->vao = NULL;
+	if (!complete) {
+		fprintf(stderr, "[ARGUS]: error: unable to create the FBO of a layer!\n");
+		layer_free(&layer);
+		return NULL;
+	}
+
+	// Creates the quad. The rows of the texture go upward, so its y coordinates are flipped.
+	float vertices[12] = {
+		rect.x,rect.y,rect.x+rect.w,rect.y+rect.h,rect.x,rect.y+rect.h,
+		rect.x,rect.y,rect.x+rect.w,rect.y,rect.x+rect.w,rect.y+rect.h
+	};
+	float textures[12] = {0,1,1,0,0,0,0,1,1,1,1,0};
+	void *data[2] = {vertices, textures};
+	int sizes[2] = {2,2};
+	int gl_types[2] = {GL_FLOAT, GL_FLOAT};
+	layer->vao = vao_create(data, sizes, gl_types, 6,2);
+	if (!layer->vao) {
+		fprintf(stderr, "[ARGUS]: error: unable to create the VAO of a layer!\n");
+		layer_free(&layer);
+		return NULL;
+	}
+	return layer;
+}
+
+/// @brief Frees the memory allocated for a Layer.
+/// @param p_layer A pointer to the pointer of the Layer to be freed. Cannot be NULL.
+/// @note After freeing, the pointer *p_layer is set to NULL to avoid double-free.
+void layer_free(Layer **p_layer) {
+	Layer *layer = *p_layer;
+	if (!layer) return;
+	vao_free(&layer->vao);
+	glDeleteFramebuffers(1, &layer->fbo);
+	glDeleteTextures(1, &layer->texture.texture_id);
+	free(layer);
+	*p_layer = NULL;
+}
+
+
+/// @brief Redirects the rendering into the layer.
+/// @param layer The layer to render into. Its content is cleared.
+/// @note The viewport is placed so that the window coordinates of the rect of the layer
+/// land on its texture, so the usual render functions can be used unchanged.
+void layer_begin(Layer *layer) {
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &layer->old_fbo);
+	glGetIntegerv(GL_VIEWPORT, layer->old_viewport);
+	const float window_width = layer->texture.width/layer->rect.w;
+	const float window_height = layer->texture.height/layer->rect.h;
+	glBindFramebuffer(GL_FRAMEBUFFER, layer->fbo);
+	glViewport(
+		-layer->rect.x*window_width, -(1.0f-layer->rect.y-layer->rect.h)*window_height, 
+		window_width, window_height
+	);
+	layer->old_recording = render_record(false);
+	const GLfloat transparent[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	glClearBufferfv(GL_COLOR, 0, transparent);
+
+	// Keeps the alpha of the opaque parts at 1, so that the layer is drawn back unchanged.
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+/// @brief Restores the rendering into the previous target.
+/// @param layer The layer that was rendered into. Its content is then valid.
+void layer_end(Layer *layer) {
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glBindFramebuffer(GL_FRAMEBUFFER, layer->old_fbo);
+	glViewport(layer->old_viewport[0], layer->old_viewport[1], layer->old_viewport[2], layer->old_viewport[3]);
+	render_record(layer->old_recording);
+	layer->valid = true;
+}
+
+/// @brief Draws the content of the layer.
+/// @param layer The layer to draw.
+void layer_render(Layer *layer) {
+	if (!layer) return;
+	render_texture(layer->vao, &layer->texture, 1.0f);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <GL/glew.h>
+#include "structs.h"
+#include "texture.h"
+#include "vao.h"
+
+
+
+/// @struct Layer
+/// @brief An offscreen copy of a part of the window, drawn again as a single textured quad.
+typedef struct {
+	GLuint fbo;			///< The FBO OpenGL id.
+	Texture texture;	///< The texture the FBO renders into.
+	VAO *vao;			///< The quad used to draw the texture into the window.
+	Rect rect;			///< The rect of the window covered by the layer.
+	bool valid;			///< true if the content of the texture is up to date.
+	GLint old_fbo;			///< The FBO bound before layer_begin.
+	GLint old_viewport[4];	///< The viewport set before layer_begin.
+	bool old_recording;		///< true if the draws were recorded before layer_begin.
+} Layer;
+
+
+// Creates a layer covering a rect of the window.
+Layer *layer_create(Rect rect, int window_width, int window_height);
+
+// Frees the memory allocated for a Layer.
+void layer_free(Layer **p_layer);
+
+
+// Redirects the rendering into the layer.
+void layer_begin(Layer *layer);
+
+// Restores the rendering into the previous target.
+void layer_end(Layer *layer);
+
+// Draws the content of the layer.
+void layer_render(Layer *layer);
@@ -0,0 +1,132 @@
+#include "minmax_window.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <float.h>
+
+
+
+/// @brief Allocates the buffers of a MonotonicDeque.
+/// @param deque The deque to initialize.
+/// @param cap The maximal number of values in the deque.
+/// @return false if there was an error.
+static bool monotonicdeque_init(MonotonicDeque *deque, size_t cap) {
+	deque->first = 0;
+	deque->size = 0;
+	deque->val = malloc(cap*sizeof(float));
+	deque->seq = malloc(cap*sizeof(size_t));
+	return deque->val && deque->seq;
+}
+
+/// @brief Pushes a value at the back of a MonotonicDeque.
+/// @param deque The deque where to push the value.
+/// @param cap The capacity of the deque.
+/// @param val The value to push.
+/// @param seq The push id of the value.
+/// @param is_max true if the deque is decreasing, false if it's increasing.
+/// @note The values of the back that can't be an extremum anymore are removed first.
+static inline void monotonicdeque_push(MonotonicDeque *deque, size_t cap, float val, size_t seq, bool is_max) {
+	while (deque->size) {
+		const float back = deque->val[(deque->first + deque->size - 1) % cap];
+		if (is_max ? back > val : back < val) break;
+		--deque->size;
+	}
+	const size_t slot = (deque->first + deque->size) % cap;
+	deque->val[slot] = val;
+	deque->seq[slot] = seq;
+	++deque->size;
+}
+
+/// @brief Removes the values of the front of a MonotonicDeque pushed before a given id.
+/// @param deque The deque to update.
+/// @param cap The capacity of the deque.
+/// @param seq The push id of the oldest value to keep.
+static inline void monotonicdeque_evict(MonotonicDeque *deque, size_t cap, size_t seq) {
+	while (deque->size && deque->seq[deque->first] < seq) {
+		deque->first = (deque->first + 1) % cap;
+		--deque->size;
+	}
+}
+
+
+/// @brief Allocates a MinMaxWindow over the last cap values.
+/// @param cap The number of values of the window.
+/// @return The initialized window.
+MinMaxWindow *minmaxwindow_create(size_t cap) {
+	if (cap <= 0) {
+		fprintf(stderr, "[ARGUS]: error: MinMaxWindow capacity must be greater than 0. Given capacity: %ld\n", cap);
+		return NULL;
+	}
+
+	// Malloc the MinMaxWindow struct.
+	MinMaxWindow *window = malloc(sizeof(MinMaxWindow));
+	if (!window) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the MinMaxWindow structure.\n");
+		return NULL;
+	}
+	window->cap = cap;
+	window->count = 0;
+
+	// Malloc the deques.
+	const bool min_ok = monotonicdeque_init(&window->min, cap);
+	const bool max_ok = monotonicdeque_init(&window->max, cap);
+	if (!min_ok || !max_ok) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the MinMaxWindow's deques.\n");
+		minmaxwindow_free(&window);
+		return NULL;
+	}
+	return window;
+}
+
+/// @brief Frees the memory allocated for a MinMaxWindow.
+/// @param p_window A pointer to the pointer of the MinMaxWindow to be freed. Cannot be NULL.
+/// @note After freeing, the pointer *p_window is set to NULL to avoid double-free.
+void minmaxwindow_free(MinMaxWindow **p_window) {
+	MinMaxWindow *window = *p_window;
+	if (!window) return;
+	free(window->min.val);
+	free(window->min.seq);
+	free(window->max.val);
+	free(window->max.seq);
+	free(window);
+	*p_window = NULL;
+}
+
+
+/// @brief Pushes values into the window, evicting the oldest ones.
+/// @param window The window where to push the values.
+/// @param data The values to push.
+/// @param n The number of values to push.
+void minmaxwindow_push(MinMaxWindow *window, const float *data, size_t n) {
+	const size_t cap = window->cap;
+
+	// Only the last cap values can stay in the window.
+	if (n > cap) {
+		window->count += n-cap;
+		data += n-cap;
+		n = cap;
+	}
+	for (size_t i = 0; i < n; ++i) {
+		const size_t seq = window->count++;
+		const size_t oldest = seq+1 > cap ? seq+1-cap : 0;
+		monotonicdeque_evict(&window->min, cap, oldest);
+		monotonicdeque_evict(&window->max, cap, oldest);
+		monotonicdeque_push(&window->min, cap, data[i], seq, false);
+		monotonicdeque_push(&window->max, cap, data[i], seq, true);
+	}
+}
+
+/// @brief Gets the minimal value of the window.
+/// @param window The window to read.
+/// @return The minimal value, or FLT_MAX if the window is empty.
+float minmaxwindow_min(const MinMaxWindow *window) {
+	return window->min.size ? window->min.val[window->min.first] : FLT_MAX;
+}
+
+/// @brief Gets the maximal value of the window.
+/// @param window The window to read.
+/// @return The maximal value, or -FLT_MAX if the window is empty.
+float minmaxwindow_max(const MinMaxWindow *window) {
+	return window->max.size ? window->max.val[window->max.first] : -FLT_MAX;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+
+
+/// @struct MonotonicDeque
+/// @brief A deque of values sorted in a given order, along with the id of their push.
+typedef struct {
+	float *val;		///< The values of the deque, stored in a ring.
+	size_t *seq;	///< The push id of each value.
+	size_t first;	///< The slot of the front of the deque.
+	size_t size;	///< The number of values in the deque.
+} MonotonicDeque;
+
+/// @struct MinMaxWindow
+/// @brief Tracks the minimal and maximal values among the last cap values pushed.
+/// @note Each push costs O(1) amortized and the extrema are read in O(1), so it can 
+/// follow a RingBuffer of the same capacity without rescanning it.
+typedef struct {
+	MonotonicDeque min;	///< Increasing deque, whose front is the minimum.
+	MonotonicDeque max;	///< Decreasing deque, whose front is the maximum.
+	size_t cap;		///< The number of values of the window.
+	size_t count;	///< The total number of values pushed.
+} MinMaxWindow;
+
+
+// Allocates a MinMaxWindow over the last cap values.
+MinMaxWindow *minmaxwindow_create(size_t cap);
+
+// Frees the memory allocated for a MinMaxWindow.
+void minmaxwindow_free(MinMaxWindow **p_window);
+
+
+// Pushes values into the window, evicting the oldest ones.
+void minmaxwindow_push(MinMaxWindow *window, const float *data, size_t n);
+
+// Gets the minimal value of the window.
+float minmaxwindow_min(const MinMaxWindow *window);
+
+// Gets the maximal value of the window.
+float minmaxwindow_max(const MinMaxWindow *window);
@@ -0,0 +1,186 @@
+#include "pyramid.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+
+/// @brief Allocates a Pyramid over a buffer of cap slots.
+/// @param cap The number of slots of the summarized buffer.
+/// @return The initialized pyramid. Every slot is marked as modified.
+Pyramid *pyramid_create(size_t cap) {
+	if (cap <= 0) {
+		fprintf(stderr, "[ARGUS]: error: Pyramid capacity must be greater than 0. Given capacity: %ld\n", cap);
+		return NULL;
+	}
+
+	// Malloc the Pyramid struct.
+	Pyramid *pyramid = malloc(sizeof(Pyramid));
+	if (!pyramid) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the Pyramid structure.\n");
+		return NULL;
+	}
+	pyramid->cap = cap;
+	pyramid->levels = 1;
+	for (size_t n = (cap+PYRAMID_BLOCK-1)/PYRAMID_BLOCK; n > 1; n = (n+1)/2) ++pyramid->levels;
+
+	// Malloc the levels.
+	pyramid->min = calloc(pyramid->levels, sizeof(float*));
+	pyramid->max = calloc(pyramid->levels, sizeof(float*));
+	pyramid->blocks = malloc(pyramid->levels*sizeof(size_t));
+	if (!pyramid->min || !pyramid->max || !pyramid->blocks) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the Pyramid's levels.\n");
+		pyramid_free(&pyramid);
+		return NULL;
+	}
+	size_t n = (cap+PYRAMID_BLOCK-1)/PYRAMID_BLOCK;
+	for (size_t k = 0; k < pyramid->levels; ++k) {
+		pyramid->blocks[k] = n;
+		pyramid->min[k] = malloc(n*sizeof(float));
+		pyramid->max[k] = malloc(n*sizeof(float));
+		if (!pyramid->min[k] || !pyramid->max[k]) {
+			fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the Pyramid's levels.\n");
+			pyramid_free(&pyramid);
+			return NULL;
+		}
+		n = (n+1)/2;
+	}
+	pyramid->dirty_first = 0;
+	pyramid->dirty_last = pyramid->blocks[0];
+	return pyramid;
+}
+
+/// @brief Frees the memory allocated for a Pyramid.
+/// @param p_pyramid A pointer to the pointer of the Pyramid to be freed. Cannot be NULL.
+/// @note After freeing, the pointer *p_pyramid is set to NULL to avoid double-free.
+void pyramid_free(Pyramid **p_pyramid) {
+	Pyramid *pyramid = *p_pyramid;
+	if (!pyramid) return;
+	for (size_t k = 0; k < pyramid->levels; ++k) {
+		if (pyramid->min) free(pyramid->min[k]);
+		if (pyramid->max) free(pyramid->max[k]);
+	}
+	free(pyramid->min);
+	free(pyramid->max);
+	free(pyramid->blocks);
+	free(pyramid);
+	*p_pyramid = NULL;
+}
+
+
+/// @brief Marks slots of the summarized buffer as modified.
+/// @param pyramid The pyramid to update.
+/// @param slot The first modified slot.
+/// @param n The number of modified slots. They can wrap around the end of the buffer.
+/// @note The blocks are only recomputed by pyramid_flush.
+void pyramid_mark(Pyramid *pyramid, size_t slot, size_t n) {
+	if (!n) return;
+	slot %= pyramid->cap;
+	size_t first = slot/PYRAMID_BLOCK;
+	size_t last = (slot+n-1)/PYRAMID_BLOCK + 1;
+	if (n >= pyramid->cap || last > pyramid->blocks[0]) {
+		first = 0;
+		last = pyramid->blocks[0];
+	}
+	if (pyramid->dirty_first >= pyramid->dirty_last) {
+		pyramid->dirty_first = first;
+		pyramid->dirty_last = last;
+		return;
+	}
+	if (first < pyramid->dirty_first) pyramid->dirty_first = first;
+	if (last > pyramid->dirty_last) pyramid->dirty_last = last;
+}
+
+/// @brief Recomputes the blocks that contain modified slots.
+/// @param pyramid The pyramid to update.
+/// @param data The summarized buffer. Must be cap values long.
+/// @note The blocks that contain slots that were never written hold meaningless values, 
+/// but they're never used by pyramid_query for a range of written slots.
+void pyramid_flush(Pyramid *pyramid, const float *data) {
+	size_t first = pyramid->dirty_first;
+	size_t last = pyramid->dirty_last;
+	if (first >= last) return;
+
+	// Recomputes the modified blocks of the first level from the data.
+	for (size_t b = first; b < last; ++b) {
+		const size_t end = (b+1)*PYRAMID_BLOCK < pyramid->cap ? (b+1)*PYRAMID_BLOCK : pyramid->cap;
+		float min = data[b*PYRAMID_BLOCK];
+		float max = min;
+		for (size_t i = b*PYRAMID_BLOCK+1; i < end; ++i) {
+			if (data[i] < min) min = data[i];
+			if (data[i] > max) max = data[i];
+		}
+		pyramid->min[0][b] = min;
+		pyramid->max[0][b] = max;
+	}
+
+	// Propagates the changes to the parent blocks.
+	for (size_t k = 1; k < pyramid->levels; ++k) {
+		first /= 2;
+		last = (last+1)/2;
+		const size_t children = pyramid->blocks[k-1];
+		const float *child_min = pyramid->min[k-1];
+		const float *child_max = pyramid->max[k-1];
+		for (size_t b = first; b < last; ++b) {
+			float min = child_min[2*b];
+			float max = child_max[2*b];
+			if (2*b+1 < children) {
+				if (child_min[2*b+1] < min) min = child_min[2*b+1];
+				if (child_max[2*b+1] > max) max = child_max[2*b+1];
+			}
+			pyramid->min[k][b] = min;
+			pyramid->max[k][b] = max;
+		}
+	}
+	pyramid->dirty_first = 0;
+	pyramid->dirty_last = 0;
+}
+
+/// @brief Gets the minimal and maximal values of a range of slots.
+/// @param pyramid The pyramid of the buffer. Must have been flushed since the last modification.
+/// @param data The summarized buffer.
+/// @param first The first slot of the range.
+/// @param last The slot after the last one of the range. Must be greater than first and lower or equal to cap.
+/// @param min Where to store the minimal value.
+/// @param max Where to store the maximal value.
+void pyramid_query(const Pyramid *pyramid, const float *data, size_t first, size_t last, float *min, float *max) {
+	float val_min = data[first];
+	float val_max = val_min;
+
+	// Reads directly the slots that are not in a full block.
+	while (first < last && first % PYRAMID_BLOCK) {
+		if (data[first] < val_min) val_min = data[first];
+		if (data[first] > val_max) val_max = data[first];
+		++first;
+	}
+	while (last > first && last % PYRAMID_BLOCK && last != pyramid->cap) {
+		--last;
+		if (data[last] < val_min) val_min = data[last];
+		if (data[last] > val_max) val_max = data[last];
+	}
+
+	// Reads the full blocks from the highest possible levels.
+	if (first == last) {
+		*min = val_min;
+		*max = val_max;
+		return;
+	}
+	size_t l = first/PYRAMID_BLOCK;
+	size_t r = (last+PYRAMID_BLOCK-1)/PYRAMID_BLOCK;
+	for (size_t k = 0; l < r; ++k) {
+		if (l & 1) {
+			if (pyramid->min[k][l] < val_min) val_min = pyramid->min[k][l];
+			if (pyramid->max[k][l] > val_max) val_max = pyramid->max[k][l];
+			++l;
+		}
+		if (r & 1) {
+			--r;
+			if (pyramid->min[k][r] < val_min) val_min = pyramid->min[k][r];
+			if (pyramid->max[k][r] > val_max) val_max = pyramid->max[k][r];
+		}
+		l /= 2;
+		r /= 2;
+	}
+	*min = val_min;
+	*max = val_max;
+}
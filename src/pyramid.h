@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stddef.h>
+
+
+// Number of values summarized by each block of the first level of a pyramid.
+#define PYRAMID_BLOCK 64
+
+
+/// @struct Pyramid
+/// @brief A min/max pyramid over the slots of a buffer.
+/// @note Each level summarizes pairs of blocks of the previous one, so any range of slots
+/// can be reduced in a number of steps proportional to the logarithm of the capacity.
+typedef struct {
+	float **min;	///< The minimal value of each block, for each level.
+	float **max;	///< The maximal value of each block, for each level.
+	size_t *blocks;	///< The number of blocks of each level.
+	size_t levels;	///< The number of levels.
+	size_t cap;		///< The number of slots of the summarized buffer.
+	size_t dirty_first;	///< The first block of the first level that must be recomputed.
+	size_t dirty_last;	///< The block after the last one of the first level that must be recomputed.
+} Pyramid;
+
+
+// Allocates a Pyramid over a buffer of cap slots.
+Pyramid *pyramid_create(size_t cap);
+
+// Frees the memory allocated for a Pyramid.
+void pyramid_free(Pyramid **p_pyramid);
+
+
+// Marks slots of the summarized buffer as modified.
+void pyramid_mark(Pyramid *pyramid, size_t slot, size_t n);
+
+// Recomputes the blocks that contain modified slots.
+void pyramid_flush(Pyramid *pyramid, const float *data);
+
+// Gets the minimal and maximal values of a range of slots.
+void pyramid_query(const Pyramid *pyramid, const float *data, size_t first, size_t last, float *min, float *max);
@@ -1,25 +1,272 @@
 #include "render.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include "vertex_arena.h"
 
-/// @brief Renders a text VAO.
-/// @param glyphs The glyphs to use to render text from.
-/// @param shaders The main shaders array.
-/// @param vao The text VAO.
-/// @param color The color of the text
-/// @note If vao == NULL, nothing will be drawn.
-void render_text(Glyphs *glyphs, VAO *vao, Color color) {
-	if (!vao) return;
-	shader_use(shaders[SHADER_TEXT]);
-		vao_bind(vao);
-			glUniform3f(
-				shader_uniform_location(shaders[SHADER_TEXT], "color"), 
-				color.r, color.g, color.b
-			);
-			glyphs_bind(glyphs);
-				glDrawArrays(GL_TRIANGLES, 0, vao->size);
-			glyphs_bind(NULL);
-		vao_bind(NULL);
-	shader_use(NULL);
+
+
+/// @struct RenderCommand
+/// @brief A draw recorded to be done at the end of the frame.
+typedef struct {
+	int depth;				///< The depth of the draw, the first sort key.
+	ShaderName shader;		///< The shader to use, the second sort key.
+	GLuint texture_id;		///< The texture to bind, or 0. The third sort key.
+	GLuint vao_id;			///< The VAO to draw.
+	GLenum mode;			///< The primitives to draw.
+	GLsizei count;			///< The number of vertices to draw.
+	GLsizei instances;		///< The number of instances to draw, or 0 if the draw isn't instanced.
+	const GLint *firsts;	///< The first vertex of each range of a multi draw, or NULL.
+	const GLsizei *counts;	///< The number of vertices of each range of a multi draw.
+	GLsizei n;				///< The number of ranges of a multi draw, or of colors of the glyph shader.
+	const float *colors;	///< The color of each range of a multi draw in the vertex arena, or NULL.
+	bool scissor;			///< true if the draw is clipped to box.
+	GLint box[4];			///< The scissor box in pixels (x, y, w, h).
+	float values[16];		///< The values of the uniforms of the shader.
+	size_t order;			///< The recording order, the last sort key.
+} RenderCommand;
+
+/// @struct RenderState
+/// @brief The OpenGL state set by the previous draw, to skip the changes that aren't needed.
+typedef struct {
+	ShaderName shader;	///< The shader in use, or SHADERNAME_SIZE if none.
+	GLuint vao_id;		///< The VAO bound.
+	GLuint texture_id;	///< The texture bound.
+	bool scissor;		///< true if the scissor test is enabled.
+	GLint box[4];		///< The scissor box.
+} RenderState;
+
+// State of OpenGL between two draws.
+#define RENDERSTATE_INIT (RenderState){SHADERNAME_SIZE, 0, 0, false, {0,0,0,0}}
+
+
+// Draws recorded for the current frame.
+static RenderCommand *commands = NULL;	///< The recorded draws.
+static size_t commands_size = 0;		///< The number of recorded draws.
+static size_t commands_cap = 0;			///< The number of draws the buffer can hold.
+static bool recording = false;			///< true if the draws are recorded instead of being done.
+static int current_depth = RENDERDEPTH_BACKGROUND;	///< The depth of the next recorded draws.
+static GLuint colors_id = 0;			///< The storage buffer of the colors of the ranges of the data shader.
+
+
+
+/// @brief Sets the uniforms of a draw.
+/// @param command The draw.
+/// @param shader The shader used by the draw.
+static void render_set_uniforms(const RenderCommand *command, Shader *shader) {
+	const float *v = command->values;
+	switch (command->shader) {
+		case SHADER_SHAPE:
+			glUniform1f(shader_uniform(shader, UNIFORM_TRANSPARENCY), v[0]);
+			break;
+		case SHADER_CURVE:
+			glUniform3f(shader_uniform(shader, UNIFORM_FRAG_COLOR), v[0], v[1], v[2]);
+			break;
+		case SHADER_SCATTER:
+			glUniform2f(shader_uniform(shader, UNIFORM_MARKER_SIZE), v[11], v[12]);
+			glUniform3f(shader_uniform(shader, UNIFORM_FRAG_COLOR), v[0], v[1], v[2]);
+			// fall through
+		case SHADER_DATA:
+			glUniform4f(shader_uniform(shader, UNIFORM_LIMITS), v[3], v[4], v[5], v[6]);
+			glUniform4f(shader_uniform(shader, UNIFORM_RECT), v[7], v[8], v[9], v[10]);
+			break;
+		case SHADER_TEXTURE:
+			glUniform1f(shader_uniform(shader, UNIFORM_FADE), v[0]);
+			break;
+		case SHADER_GLYPH:
+			glUniform3fv(shader_uniform(shader, UNIFORM_COLORS), command->n, v);
+			break;
+		default:
+			break;
+	}
+}
+
+/// @brief Uploads the colors of the ranges of a multi draw into the storage buffer read by the data shader.
+/// @param command The draw.
+/// @note The buffer is orphaned on each upload, so that it never waits for the previous draws.
+static void render_upload_colors(const RenderCommand *command) {
+	if (!colors_id) glGenBuffers(1, &colors_id);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, colors_id);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, 3*command->n*sizeof(float), command->colors, GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, colors_id);
+}
+
+/// @brief Does a draw, changing only the parts of the OpenGL state that differ from the previous draw.
+/// @param command The draw to do.
+/// @param state The state left by the previous draw, updated by this one.
+/// @note The id of the VAO of the vertex arena is only read here, since the arena can grow
+/// between the recording of a draw and the end of the frame.
+static void render_execute(const RenderCommand *command, RenderState *state) {
+	Shader *shader = shaders[command->shader];
+	if (state->shader != command->shader) {
+		shader_use(shader);
+		state->shader = command->shader;
+	}
+	const GLuint vao_id = command->colors ? vertexarena_vao_id() : command->vao_id;
+	if (state->vao_id != vao_id) {
+		glBindVertexArray(vao_id);
+		state->vao_id = vao_id;
+	}
+	if (state->texture_id != command->texture_id) {
+		glBindTexture(GL_TEXTURE_2D, command->texture_id);
+		state->texture_id = command->texture_id;
+	}
+	if (state->scissor != command->scissor) {
+		if (command->scissor) glEnable(GL_SCISSOR_TEST);
+		else glDisable(GL_SCISSOR_TEST);
+		state->scissor = command->scissor;
+	}
+	if (command->scissor && (state->box[0] != command->box[0] || state->box[1] != command->box[1] ||
+		state->box[2] != command->box[2] || state->box[3] != command->box[3])) {
+		glScissor(command->box[0], command->box[1], command->box[2], command->box[3]);
+		for (int i = 0; i < 4; ++i) state->box[i] = command->box[i];
+	}
+	render_set_uniforms(command, shader);
+
+	// Draws the primitives. Without the draw id, the ranges colored per draw are drawn one by one.
+	if (command->colors && !shader_has_draw_id()) {
+		for (GLsizei i = 0; i < command->n; ++i) {
+			glUniform3fv(shader_uniform(shader, UNIFORM_FRAG_COLOR), 1, command->colors+3*i);
+			glDrawArrays(command->mode, command->firsts[i], command->counts[i]);
+		}
+	} else if (command->firsts) {
+		if (command->colors) render_upload_colors(command);
+		glMultiDrawArrays(command->mode, command->firsts, command->counts, command->n);
+	} else if (command->instances) glDrawArraysInstanced(command->mode, 0, command->count, command->instances);
+	else glDrawArrays(command->mode, 0, command->count);
+}
+
+/// @brief Restores the OpenGL state after draws.
+/// @param state The state left by the last draw.
+static void render_reset(const RenderState *state) {
+	if (state->scissor) glDisable(GL_SCISSOR_TEST);
+	if (state->texture_id) glBindTexture(GL_TEXTURE_2D, 0);
+	if (state->vao_id) glBindVertexArray(0);
+	if (state->shader != SHADERNAME_SIZE) shader_use(NULL);
+}
+
+/// @brief Records a draw, or does it right away if the draws aren't recorded.
+/// @param command The draw. Its depth and its order are set here.
+static void render_submit(RenderCommand *command) {
+	command->depth = current_depth;
+
+	// Grows the buffer if needed. The draw is done right away if it can't be recorded.
+	if (recording && commands_size == commands_cap) {
+		const size_t cap = commands_cap ? 2*commands_cap : 64;
+		RenderCommand *data = realloc(commands, cap*sizeof(RenderCommand));
+		if (data) {
+			commands = data;
+			commands_cap = cap;
+		}
+	}
+	if (recording && commands_size < commands_cap) {
+		command->order = commands_size;
+		commands[commands_size++] = *command;
+		return;
+	}
+	RenderState state = RENDERSTATE_INIT;
+	render_execute(command, &state);
+	render_reset(&state);
+}
+
+/// @brief Compares two recorded draws by depth, shader, texture, then recording order.
+/// @param a The first draw.
+/// @param b The second draw.
+/// @return A negative value if a must be drawn before b, a positive one otherwise.
+static int render_compare(const void *a, const void *b) {
+	const RenderCommand *ca = a;
+	const RenderCommand *cb = b;
+	if (ca->depth != cb->depth) return ca->depth < cb->depth ? -1 : 1;
+	if (ca->shader != cb->shader) return ca->shader < cb->shader ? -1 : 1;
+	if (ca->texture_id != cb->texture_id) return ca->texture_id < cb->texture_id ? -1 : 1;
+	return ca->order < cb->order ? -1 : ca->order > cb->order;
+}
+
+/// @brief Gets the scissor box in pixels of a rect of the current viewport.
+/// @param command The draw to clip.
+/// @param rect The rect where the draw must stay.
+/// @param viewport The current viewport.
+static void render_set_scissor(RenderCommand *command, Rect rect, const GLint *viewport) {
+	command->scissor = true;
+	command->box[0] = viewport[0] + rect.x*viewport[2];
+	command->box[1] = viewport[1] + (1.0f-rect.y-rect.h)*viewport[3];
+	command->box[2] = rect.w*viewport[2]+1;
+	command->box[3] = rect.h*viewport[3]+1;
+}
+
+
+
+/// @brief Starts recording the draws of a frame instead of doing them.
+/// @note The VAOs and the buffers given to the render functions must stay valid until render_end.
+void render_begin(void) {
+	commands_size = 0;
+	current_depth = RENDERDEPTH_BACKGROUND;
+	recording = true;
+}
+
+/// @brief Does all the draws recorded since render_begin, grouped by depth, shader and texture.
+/// @note Within a depth the draws don't overlap, so grouping them only changes the number of
+/// state changes: a frame binds each shader about once per depth instead of once per draw.
+void render_end(void) {
+	recording = false;
+	qsort(commands, commands_size, sizeof(RenderCommand), render_compare);
+	RenderState state = RENDERSTATE_INIT;
+	for (size_t i = 0; i < commands_size; ++i) render_execute(commands+i, &state);
+	render_reset(&state);
+	commands_size = 0;
+}
+
+/// @brief Enables or disables the recording of the draws, until the next call.
+/// @param enable true to record the draws, false to do them right away.
+/// @return true if the draws were recorded before the call.
+/// @note This is used to draw into another target in the middle of a frame.
+bool render_record(bool enable) {
+	const bool previous = recording;
+	recording = enable;
+	return previous;
+}
+
+/// @brief Sets the depth of the next recorded draws.
+/// @param depth The depth, a RenderDepth or RENDERDEPTH_DATA plus the index of a curve.
+void render_set_depth(int depth) {
+	current_depth = depth;
+}
+
+/// @brief Frees the memory allocated for the recorded draws.
+/// @note The storage buffer of the data shader colors is deleted too, so this must be
+/// called before the OpenGL context is.
+void render_free_commands(void) {
+	if (colors_id) glDeleteBuffers(1, &colors_id);
+	colors_id = 0;
+	free(commands);
+	commands = NULL;
+	commands_size = 0;
+	commands_cap = 0;
+	recording = false;
+}
+
+
+
+/// @brief Renders all the characters of a text batch in a single draw call.
+/// @param glyphs The glyphs set used to lay the characters out.
+/// @param batch The batch to render. It must have been uploaded since its last change.
+/// @param colors The palette indexed by the color of the characters.
+/// @param n The number of colors, at most TEXTBATCH_COLORS.
+/// @note If batch == NULL, nothing will be drawn.
+void render_text_batch(Glyphs *glyphs, TextBatch *batch, const Color *colors, int n) {
+	if (!batch || !batch->vao || !batch->size) return;
+	if (n > TEXTBATCH_COLORS) n = TEXTBATCH_COLORS;
+	RenderCommand command = {
+		.shader = SHADER_GLYPH, .texture_id = glyphs->texture_id, .vao_id = batch->vao->vao_id,
+		.mode = GL_TRIANGLE_STRIP, .count = 4, .instances = batch->size, .n = n
+	};
+	for (int i = 0; i < n; ++i) {
+		command.values[3*i] = colors[i].r;
+		command.values[3*i+1] = colors[i].g;
+		command.values[3*i+2] = colors[i].b;
+	}
+	render_submit(&command);
 }
 
 /// @brief Renders a shape from a VAO with a given transparency.
@@ -28,27 +275,83 @@ void render_text(Glyphs *glyphs, VAO *vao, Color color) {
 /// @note If vao == NULL, nothing will be drawn.
 void render_shape(VAO *vao, float transparency) {
 	if (!vao) return;
-	shader_use(shaders[SHADER_SHAPE]);
-		vao_bind(vao);
-			glUniform1f(shader_uniform_location(shaders[SHADER_SHAPE], "transparency"), transparency);
-			glDrawArrays(GL_TRIANGLES, 0, vao->size);
-		vao_bind(NULL);
-	shader_use(NULL);
+	RenderCommand command = {
+		.shader = SHADER_SHAPE, .vao_id = vao->vao_id,
+		.mode = GL_TRIANGLES, .count = vao->size, .values = {transparency}
+	};
+	render_submit(&command);
 }
 
 /// @brief Renders a curve from a VAO with a given transparency.
 /// @param vao VAO of the curve to render.
 void render_curve(VAO *vao, Color color, bool continuous) {
 	if (!vao) return;
-	shader_use(shaders[SHADER_CURVE]);
-		vao_bind(vao);
-			glUniform3f(
-				shader_uniform_location(shaders[SHADER_TEXT], "color"), 
-				color.r, color.g, color.b
-			);
-			glDrawArrays(continuous ? GL_LINE_STRIP : GL_LINES, 0, vao->size);
-		vao_bind(NULL);
-	shader_use(NULL);
+	RenderCommand command = {
+		.shader = SHADER_CURVE, .vao_id = vao->vao_id, .mode = continuous ? GL_LINE_STRIP : GL_LINES,
+		.count = vao->size, .values = {color.r, color.g, color.b}
+	};
+	render_submit(&command);
+}
+
+/// @brief Renders ranges of raw data points of the vertex arena as line strips projected into a rect.
+/// @param first The first vertex of each range in the vertex arena.
+/// @param count The number of vertices of each range.
+/// @param colors The color (r, g, b) of each range.
+/// @param n The number of ranges.
+/// @param limits The axis limits (x_min, y_min, x_max, y_max).
+/// @param rect The rect where the limits are projected. Nothing is drawn outside of it.
+/// @note All the ranges are drawn by a single glMultiDrawArrays, each one reading its color
+/// with its draw id, so the curves of a graph cost one draw call whatever their number.
+/// Without GL_ARB_shader_draw_parameters, they are drawn one by one with a color uniform.
+void render_data_ranges(const GLint *first, const GLsizei *count, const float *colors, int n, 
+Rect limits, Rect rect) {
+	if (!n || !vertexarena_vao_id()) return;
+	RenderCommand command = {
+		.shader = SHADER_DATA, .mode = GL_LINE_STRIP,
+		.firsts = first, .counts = count, .n = n, .colors = colors,
+		.values = {
+			0.0f, 0.0f, 0.0f,
+			limits.x, limits.y, limits.w, limits.h,
+			rect.x, rect.y, rect.w, rect.h
+		}
+	};
+
+	// Converts the rect into the pixels of the current viewport to clip the curve.
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	render_set_scissor(&command, rect, viewport);
+	render_submit(&command);
+}
+
+/// @brief Renders raw data points of an InstancedVAO as markers projected into a rect.
+/// @param vao InstancedVAO of the data to render. Its shared list is the marker quad 
+/// and its instance lists are the raw x and y values.
+/// @param color The color of the markers.
+/// @param limits The axis limits (x_min, y_min, x_max, y_max).
+/// @param rect The rect where the limits are projected. Nothing is drawn outside of it.
+/// @param marker_size The diameter of the markers in pixels.
+/// @param n The number of points to draw.
+/// @note If vao == NULL, nothing will be drawn.
+void render_data_scatter(InstancedVAO *vao, Color color, Rect limits, Rect rect, float marker_size, size_t n) {
+	if (!vao || !n) return;
+
+	// Converts the rect into the pixels of the current viewport to clip the markers.
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	// Draws one marker quad per point.
+	RenderCommand command = {
+		.shader = SHADER_SCATTER, .vao_id = vao->vao_id, .mode = GL_TRIANGLE_STRIP,
+		.count = 4, .instances = n,
+		.values = {
+			color.r, color.g, color.b,
+			limits.x, limits.y, limits.w, limits.h,
+			rect.x, rect.y, rect.w, rect.h,
+			0.5f*marker_size/viewport[2], 0.5f*marker_size/viewport[3]
+		}
+	};
+	render_set_scissor(&command, rect, viewport);
+	render_submit(&command);
 }
 
 /// @brief Renders a texture from a VAO.
@@ -56,12 +359,9 @@ void render_curve(VAO *vao, Color color, bool continuous) {
 /// @param texture The texture to use.
 void render_texture(VAO *vao, Texture *texture, float fade) {
 	if (!vao) return;
-	shader_use(shaders[SHADER_TEXTURE]);
-		vao_bind(vao);
-			glUniform1f(shader_uniform_location(shaders[SHADER_TEXTURE], "fade"), fade);
-			texture_bind(texture);
-			glDrawArrays(GL_TRIANGLES, 0, vao->size);
-			texture_bind(NULL);
-		vao_bind(NULL);
-	shader_use(NULL);
+	RenderCommand command = {
+		.shader = SHADER_TEXTURE, .texture_id = texture ? texture->texture_id : 0, .vao_id = vao->vao_id,
+		.mode = GL_TRIANGLES, .count = vao->size, .values = {fade}
+	};
+	render_submit(&command);
 }
@@ -6,10 +6,41 @@
 #include "vao.h"
 #include "structs.h"
 #include "texture.h"
+#include "text_batch.h"
 
 
-// Renders a text VAO.
-void render_text(Glyphs *glyphs, VAO *vao, Color color);
+/// @enum RenderDepth
+/// @brief The order in which the recorded draws are done. Draws of the same depth
+/// don't overlap, so they can be grouped by shader and texture.
+/// @note The curves are drawn in their order, so the i-th curve of a graph uses RENDERDEPTH_DATA+i.
+/// The consecutive line curves of a graph are drawn together with the depth of the first one.
+typedef enum {
+	RENDERDEPTH_BACKGROUND = 0,	///< The background of the graphs, or their layers.
+	RENDERDEPTH_TEXT = 1,		///< The texts of the graphs.
+	RENDERDEPTH_GRID = 2,		///< The grids of the graphs.
+	RENDERDEPTH_DATA = 3,		///< The first curve of the graphs.
+	RENDERDEPTH_OVERLAY = 1<<20	///< The buttons, above all the curves.
+} RenderDepth;
+
+
+// Starts recording the draws of a frame instead of doing them.
+void render_begin(void);
+
+// Does all the draws recorded since render_begin, grouped by depth, shader and texture.
+void render_end(void);
+
+// Enables or disables the recording of the draws, until the next call.
+bool render_record(bool enable);
+
+// Sets the depth of the next recorded draws.
+void render_set_depth(int depth);
+
+// Frees the memory allocated for the recorded draws.
+void render_free_commands(void);
+
+
+// Renders all the characters of a text batch in a single draw call.
+void render_text_batch(Glyphs *glyphs, TextBatch *batch, const Color *colors, int n);
 
 // Renders a shape from a VAO with a given transparency.
 void render_shape(VAO *vao, float transparency);
@@ -17,5 +48,12 @@ void render_shape(VAO *vao, float transparency);
 // Renders a curve from a VAO with a given transparency.
 void render_curve(VAO *vao, Color color, bool continuous);
 
+// Renders ranges of raw data points of the vertex arena as line strips projected into a rect.
+void render_data_ranges(const GLint *first, const GLsizei *count, const float *colors, int n, 
+	Rect limits, Rect rect);
+
+// Renders raw data points of an InstancedVAO as markers projected into a rect.
+void render_data_scatter(InstancedVAO *vao, Color color, Rect limits, Rect rect, float marker_size, size_t n);
+
 // Renders a texture from a VAO.
 void render_texture(VAO *vao, Texture *texture, float fade);
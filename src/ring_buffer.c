@@ -1,8 +1,15 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "ring_buffer.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 
 
 /// @brief Allocate a RingBuffer with a maximal of cap.
@@ -23,6 +30,7 @@ RingBuffer *ringbuffer_create(size_t cap) {
 	buffer->size = 0;
 	buffer->start = 0;
 	buffer->cap = cap;
+	buffer->mirrored = false;
 
 	// Malloc the inner buffer.
 	buffer->data = malloc(sizeof(float) * cap);
@@ -34,13 +42,86 @@ RingBuffer *ringbuffer_create(size_t cap) {
 	return buffer;
 }
 
+/// @brief Maps a memory file twice in a row.
+/// @param bytes The size of the file. Must be a multiple of the page size.
+/// @return The address of the first mapping, or NULL if there was an error.
+static float *ringbuffer_map_mirrored(size_t bytes) {
+#ifdef __linux__
+	const int fd = memfd_create("argus_ringbuffer", MFD_CLOEXEC);
+	if (fd < 0) return NULL;
+	if (ftruncate(fd, bytes)) {
+		close(fd);
+		return NULL;
+	}
+
+	// Reserves the address range, then maps the file on each half of it.
+	char *base = mmap(NULL, 2*bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED) {
+		close(fd);
+		return NULL;
+	}
+	void *first = mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	void *second = mmap(base+bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	close(fd);
+	if (first == MAP_FAILED || second == MAP_FAILED) {
+		munmap(base, 2*bytes);
+		return NULL;
+	}
+	return (float*)base;
+#else
+	(void)bytes;
+	return NULL;
+#endif
+}
+
+/// @brief Allocate a RingBuffer whose memory is mapped twice in a row.
+/// @param cap The minimal capacity of the buffer.
+/// @return The initilized buffer.
+/// @note The capacity is rounded up to a multiple of the page size. The whole content 
+/// of the buffer is then always the contiguous array data+start, of size values.
+/// @note If the memory can't be mirrored on this system, a normal buffer of capacity cap is returned.
+RingBuffer *ringbuffer_create_mirrored(size_t cap) {
+#ifdef __linux__
+	if (cap <= 0) {
+		fprintf(stderr, "[ARGUS]: error: RingBuffer capacity must be greater than 0. Given capacity: %ld\n", cap);
+		return NULL;
+	}
+
+	// Malloc the RingBuffer struct. 
+	RingBuffer *buffer = malloc(sizeof(RingBuffer));
+	if (!buffer) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the RingBuffer structure.\n");
+		return NULL;
+	}
+	const size_t page = sysconf(_SC_PAGESIZE);
+	const size_t bytes = (cap*sizeof(float) + page-1) / page * page;
+	buffer->size = 0;
+	buffer->start = 0;
+	buffer->cap = bytes / sizeof(float);
+	buffer->mirrored = true;
+
+	// Maps the inner buffer.
+	buffer->data = ringbuffer_map_mirrored(bytes);
+	if (buffer->data) return buffer;
+	fprintf(stderr, "[ARGUS]: warning: failed to mirror the memory of a RingBuffer. "
+		"A normal buffer will be used.\n");
+	free(buffer);
+#endif
+	return ringbuffer_create(cap);
+}
+
 /// @brief Frees the memory allocated for a RingBuffer.
 /// @param p_buffer A pointer to the pointer of the RingBuffer to be freed. Cannot be NULL.
 /// @note After freeing, the pointer *p_buffer is set to NULL to avoid double-free.
 void ringbuffer_free(RingBuffer **p_buffer) {
 	RingBuffer *buffer = *p_buffer;
 	if (!buffer) return;
+#ifdef __linux__
+	if (buffer->mirrored) munmap(buffer->data, 2*buffer->cap*sizeof(float));
+	else free(buffer->data);
+#else
 	free(buffer->data);
+#endif
 	free(buffer);
 	*p_buffer = NULL;
 }
@@ -61,7 +142,44 @@ void ringbuffer_push_back(RingBuffer *buffer, float val) {
 	size_t end = (buffer->start + buffer->size) % buffer->cap;
 	buffer->data[end] = val;
 	if (buffer->size < buffer->cap) ++buffer->size;
-	else ++buffer->start;
+	else buffer->start = (buffer->start + 1) % buffer->cap;
+}
+
+/// @brief Push values at the end of the buffer.
+/// @param buffer The buffer where to store the values.
+/// @param data The values to store.
+/// @param n The number of values to store.
+/// @note If the buffer gets full, the oldest stored values will removed.
+/// @note The values are copied in at most two parts, so this is much faster than 
+/// calling ringbuffer_push_back for each value.
+void ringbuffer_push_back_n(RingBuffer *buffer, const float *data, size_t n) {
+	const size_t cap = buffer->cap;
+
+	// Only the last cap values can stay in the buffer. They're placed in the same slots 
+	// as if they were pushed one by one.
+	size_t end = (buffer->start + buffer->size) % cap;
+	if (n >= cap) {
+		end = (end + n - cap) % cap;
+		data += n - cap;
+		memcpy(buffer->data + end, data, (cap - end)*sizeof(float));
+		memcpy(buffer->data, data + cap - end, end*sizeof(float));
+		buffer->start = end;
+		buffer->size = cap;
+		return;
+	}
+
+	// Copies the values in at most two parts if the end of the buffer is reached.
+	// The second mapping of a mirrored buffer takes care of the wrap.
+	const size_t first = buffer->mirrored || n < cap - end ? n : cap - end;
+	memcpy(buffer->data + end, data, first*sizeof(float));
+	memcpy(buffer->data, data + first, (n - first)*sizeof(float));
+
+	// Moves the start over the erased values.
+	const size_t size = buffer->size + n;
+	if (size > cap) {
+		buffer->start = (buffer->start + size - cap) % cap;
+		buffer->size = cap;
+	} else buffer->size = size;
 }
 
 /// @brief Gets a value in the buffer.
@@ -76,3 +194,66 @@ float ringbuffer_at(RingBuffer *buffer, size_t id) {
 	size_t val_id = (buffer->start + id) % buffer->cap;
 	return buffer->data[val_id];
 }
+
+/// @brief Gets the last value pushed in the buffer.
+/// @param buffer The buffer that contains the value. Must not be empty.
+/// @return The last value.
+float ringbuffer_back(const RingBuffer *buffer) {
+	if (!buffer->size) {
+		fprintf(stderr, "[ARGUS]: error: The RingBuffer is empty !\n");
+		return NAN;
+	}
+	return buffer->data[(buffer->start + buffer->size - 1) % buffer->cap];
+}
+
+/// @brief Gets a range of values of the buffer as at most two contiguous spans.
+/// @param buffer The buffer that contains the values.
+/// @param id The id of the first value of the range.
+/// @param n The number of values of the range. id+n must be lower or equal to buffer->size.
+/// @param spans Where to store the pointers to the first value of each span.
+/// @param lens Where to store the number of values of each span.
+/// @return The number of spans (0 to 2). The second span is only used if the range wraps 
+/// around the end of the inner buffer, which never happens for a mirrored buffer.
+/// @note Loops over the spans don't need any bound check nor modulo, and can be vectorized.
+int ringbuffer_spans(const RingBuffer *buffer, size_t id, size_t n, const float *spans[2], size_t lens[2]) {
+	if (id + n > buffer->size) {
+		fprintf(stderr, "[ARGUS]: error: The range [%ld,%ld[ isn't in the RingBuffer !\n", id, id+n);
+		return 0;
+	}
+	if (!n) return 0;
+	const size_t slot = (buffer->start + id) % buffer->cap;
+	spans[0] = buffer->data + slot;
+	if (buffer->mirrored || slot + n <= buffer->cap) {
+		lens[0] = n;
+		return 1;
+	}
+	lens[0] = buffer->cap - slot;
+	spans[1] = buffer->data;
+	lens[1] = n - lens[0];
+	return 2;
+}
+
+/// @brief Gets a writable span at the end of the buffer.
+/// @param buffer The buffer where to write.
+/// @param n The number of values to write. Set to the length of the returned span, which can be lower.
+/// @return The span where the new values must be written, before being added with ringbuffer_commit.
+/// @note If the buffer is full, the span holds the oldest values, which are erased by the writing.
+/// @note A span never wraps around the end of the inner buffer, so the values may need two reservations.
+float *ringbuffer_reserve(RingBuffer *buffer, size_t *n) {
+	const size_t end = (buffer->start + buffer->size) % buffer->cap;
+	const size_t len = buffer->mirrored ? buffer->cap : buffer->cap - end;
+	if (*n > len) *n = len;
+	return buffer->data + end;
+}
+
+/// @brief Adds the values written in the reserved span to the buffer.
+/// @param buffer The buffer where the values were written.
+/// @param n The number of values written. Must be lower or equal to the length of the reserved span.
+/// @note If the buffer gets full, the oldest stored values will removed.
+void ringbuffer_commit(RingBuffer *buffer, size_t n) {
+	const size_t size = buffer->size + n;
+	if (size > buffer->cap) {
+		buffer->start = (buffer->start + size - buffer->cap) % buffer->cap;
+		buffer->size = buffer->cap;
+	} else buffer->size = size;
+}
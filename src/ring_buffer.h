@@ -1,6 +1,11 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdbool.h>
+
+
+// Capacity from which the curves use mirrored RingBuffers.
+#define RINGBUFFER_MIRROR_MIN (1 << 18)
 
 
 /// @struct RingBuffer.
@@ -11,12 +16,16 @@ typedef struct {
 	size_t cap;		///< The capacity of the buffer (the length of data).
 	size_t size;	///< The size of the buffer (the number of value stored).
 	size_t start;	///< The id of the first value in the buffer.
+	bool mirrored;	///< true if data is mapped twice in a row, so that data[start+i] is valid for any i < cap.
 } RingBuffer;
 
 
 // Allocate a RingBuffer with a maximal of cap.
 RingBuffer *ringbuffer_create(size_t cap);
 
+// Allocate a RingBuffer whose memory is mapped twice in a row.
+RingBuffer *ringbuffer_create_mirrored(size_t cap);
+
 // Frees the memory allocated for a RingBuffer.
 void ringbuffer_free(RingBuffer **p_buffer);
 
@@ -29,3 +38,18 @@ void ringbuffer_push_back(RingBuffer *buffer, float val);
 
 // Gets a value in the buffer.
 float ringbuffer_at(RingBuffer *buffer, size_t id);
+
+// Gets the last value pushed in the buffer.
+float ringbuffer_back(const RingBuffer *buffer);
+
+// Push values at the end of the buffer.
+void ringbuffer_push_back_n(RingBuffer *buffer, const float *data, size_t n);
+
+// Gets a range of values of the buffer as at most two contiguous spans.
+int ringbuffer_spans(const RingBuffer *buffer, size_t id, size_t n, const float *spans[2], size_t lens[2]);
+
+// Gets a writable span at the end of the buffer.
+float *ringbuffer_reserve(RingBuffer *buffer, size_t *n);
+
+// Adds the values written in the reserved span to the buffer.
+void ringbuffer_commit(RingBuffer *buffer, size_t n);
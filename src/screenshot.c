@@ -222,6 +222,7 @@ bool screenshot_graph(Graph *graph, Glyphs *glyphs, const char *name) {
 	graph_prepare_static(graph_fullscreen, glyphs, fbo_width, fbo_height);
 	graph_prepare_dynamic(graph_fullscreen, glyphs, fbo_width, fbo_height);
 	imagebutton_free(&graph_fullscreen->save);
+	layer_free(&graph_fullscreen->layer);
 
 	// Renders the screenshot in the FBO.
 	GLint old_viewport[4];
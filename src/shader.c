@@ -32,44 +32,82 @@ void main() { \
 static const char *shape_attr_names[] = {"in_coord","in_color"};
 
 
-// Text shader data.
-/// @brief Text vertex shader source. 
-static const char source_text_shader_vert[] = 
+// Curve shader data.
+/// @brief Curve vertex shader source. 
+static const char source_curve_shader_vert[] = 
 "#version 450 core\n \
 in vec2 in_coord; \
-in vec2 in_tex_coord; \
-out vec2 tex_coord; \
 void main() { \
 	gl_Position = vec4(-1+2*in_coord.x, 1-2*in_coord.y, 0.0, 1.0); \
-	tex_coord = in_tex_coord; \
 }";
 
-/// @brief Text fragment shader source.
-static const char source_text_shader_frag[] = 
+/// @brief Curve fragment shader source.
+static const char source_curve_shader_frag[] = 
 "#version 450 core\n \
-in vec2 tex_coord; \
 out vec4 out_color; \
-uniform sampler2D tex; \
-uniform vec3 color; \
+uniform vec3 frag_color; \
 void main() { \
-	out_color = vec4(color, 1.0)*texture(tex, tex_coord); \
+	out_color = vec4(frag_color, 1); \
 }";
 
-/// @brief Attrib names for text shader.
-static const char *text_attr_names[] = {"in_coord","in_tex_coord"};
+/// @brief Attrib names for curve shader.
+static const char *curve_attr_names[] = {"in_coord"};
 
 
-// Curve shader data.
-/// @brief Curve vertex shader source. 
-static const char source_curve_shader_vert[] = 
+// Data shader data.
+/// @brief Data vertex shader source. Projects the raw data into the grid rect.
+/// @note The ranges of a multi draw are the curves of a graph, and each one takes 
+/// its color from the storage buffer bound to 0.
+static const char source_data_shader_vert[] = 
 "#version 450 core\n \
-in vec2 in_coord; \
+#extension GL_ARB_shader_draw_parameters : require\n \
+in float in_x; \
+in float in_y; \
+uniform vec4 limits; \
+uniform vec4 rect; \
+layout(std430, binding = 0) readonly buffer DrawColors { \
+	float draw_colors[]; \
+}; \
+flat out vec3 frag_color; \
 void main() { \
-	gl_Position = vec4(-1+2*in_coord.x, 1-2*in_coord.y, 0.0, 1.0); \
+	vec2 coord = vec2( \
+		(in_x-limits.x) / (limits.z-limits.x), \
+		1.0-(in_y-limits.y) / (limits.w-limits.y) \
+	); \
+	coord = rect.xy + rect.zw*coord; \
+	gl_Position = vec4(-1+2*coord.x, 1-2*coord.y, 0.0, 1.0); \
+	int i = 3*gl_DrawIDARB; \
+	frag_color = vec3(draw_colors[i], draw_colors[i+1], draw_colors[i+2]); \
 }";
 
-/// @brief Curve fragment shader source.
-static const char source_curve_shader_frag[] = 
+/// @brief Data fragment shader source.
+static const char source_data_shader_frag[] = 
+"#version 450 core\n \
+flat in vec3 frag_color; \
+out vec4 out_color; \
+void main() { \
+	out_color = vec4(frag_color, 1); \
+}";
+
+/// @brief Data vertex shader source without the draw id. The color of the curve is a uniform,
+/// so the ranges of a multi draw are drawn one by one.
+static const char source_data_fallback_shader_vert[] = 
+"#version 450 core\n \
+in float in_x; \
+in float in_y; \
+uniform vec4 limits; \
+uniform vec4 rect; \
+void main() { \
+	vec2 coord = vec2( \
+		(in_x-limits.x) / (limits.z-limits.x), \
+		1.0-(in_y-limits.y) / (limits.w-limits.y) \
+	); \
+	coord = rect.xy + rect.zw*coord; \
+	gl_Position = vec4(-1+2*coord.x, 1-2*coord.y, 0.0, 1.0); \
+}";
+
+/// @brief Data fragment shader source without the draw id.
+static const char source_data_fallback_shader_frag[] = 
 "#version 450 core\n \
 out vec4 out_color; \
 uniform vec3 frag_color; \
@@ -77,8 +115,44 @@ void main() { \
 	out_color = vec4(frag_color, 1); \
 }";
 
-/// @brief Attrib names for curve shader.
-static const char *curve_attr_names[] = {"in_coord"};
+/// @brief Attrib names for data shader.
+static const char *data_attr_names[] = {"in_x", "in_y"};
+
+
+// Scatter shader data.
+/// @brief Scatter vertex shader source. Places a marker quad around each raw data point.
+static const char source_scatter_shader_vert[] = 
+"#version 450 core\n \
+in vec2 in_corner; \
+in float in_x; \
+in float in_y; \
+uniform vec4 limits; \
+uniform vec4 rect; \
+uniform vec2 marker_size; \
+out vec2 corner; \
+void main() { \
+	vec2 coord = vec2( \
+		(in_x-limits.x) / (limits.z-limits.x), \
+		1.0-(in_y-limits.y) / (limits.w-limits.y) \
+	); \
+	coord = rect.xy + rect.zw*coord + marker_size*in_corner; \
+	gl_Position = vec4(-1+2*coord.x, 1-2*coord.y, 0.0, 1.0); \
+	corner = in_corner; \
+}";
+
+/// @brief Scatter fragment shader source. Cuts the quad into a disc.
+static const char source_scatter_shader_frag[] = 
+"#version 450 core\n \
+in vec2 corner; \
+out vec4 out_color; \
+uniform vec3 frag_color; \
+void main() { \
+	if (dot(corner, corner) > 1.0) discard; \
+	out_color = vec4(frag_color, 1); \
+}";
+
+/// @brief Attrib names for scatter shader.
+static const char *scatter_attr_names[] = {"in_corner", "in_x", "in_y"};
 
 
 // Texture shader data.
@@ -109,6 +183,45 @@ void main() { \
 static const char *texture_attr_names[] = {"in_coord", "in_tex_coord"};
 
 
+// Glyph shader data.
+/// @brief Glyph vertex shader source. Places a quad per character and computes its atlas cell.
+/// A vertical character is rotated by swapping the axes of its texture coordinates.
+static const char source_glyph_shader_vert[] = 
+"#version 450 core\n \
+in vec2 in_corner; \
+in vec4 in_rect; \
+in float in_cell; \
+in vec2 in_style; \
+uniform vec3 colors[4]; \
+out vec2 tex_coord; \
+out vec3 color; \
+void main() { \
+	vec2 coord = in_rect.xy + in_rect.zw*in_corner; \
+	gl_Position = vec4(-1+2*coord.x, 1-2*coord.y, 0.0, 1.0); \
+	vec2 corner = in_style.x > 0.5 ? vec2(1.0-in_corner.y, in_corner.x) : in_corner; \
+	float cell = floor(in_cell+0.5); \
+	tex_coord = vec2(0.0625, 0.1)*(vec2(mod(cell, 16.0), floor(cell/16.0)) + corner); \
+	color = colors[int(in_style.y)]; \
+}";
+
+/// @brief Glyph fragment shader source. The atlas stores the distance to the edge of the glyphs, 
+/// 0.5 on the edge, which is smoothed over about one pixel whatever the scale of the text.
+static const char source_glyph_shader_frag[] = 
+"#version 450 core\n \
+in vec2 tex_coord; \
+in vec3 color; \
+out vec4 out_color; \
+uniform sampler2D tex; \
+void main() { \
+	float d = texture(tex, tex_coord).r; \
+	float w = max(fwidth(d), 0.0001); \
+	out_color = vec4(color, smoothstep(0.5-w, 0.5+w, d)); \
+}";
+
+/// @brief Attrib names for glyph shader.
+static const char *glyph_attr_names[] = {"in_corner", "in_rect", "in_cell", "in_style"};
+
+
 // Shader infos.
 /// @brief Shader description structure.
 struct ShaderInfo {
@@ -125,21 +238,51 @@ static const ShaderInfo shader_infos[] = {
     [SHADER_SHAPE] = {
 		"shape", source_shape_shader_vert, source_shape_shader_frag, shape_attr_names, 2
 	},
-	[SHADER_TEXT] = {
-		"text", source_text_shader_vert, source_text_shader_frag, text_attr_names, 2
-	},
 	[SHADER_CURVE] = {
 		"curve", source_curve_shader_vert, source_curve_shader_frag, curve_attr_names, 1
 	},
+	[SHADER_DATA] = {
+		"data", source_data_shader_vert, source_data_shader_frag, data_attr_names, 2
+	},
+	[SHADER_SCATTER] = {
+		"scatter", source_scatter_shader_vert, source_scatter_shader_frag, scatter_attr_names, 3
+	},
 	[SHADER_TEXTURE] = {
 		"texture", source_texture_shader_vert, source_texture_shader_frag, texture_attr_names, 2
+	},
+	[SHADER_GLYPH] = {
+		"glyph", source_glyph_shader_vert, source_glyph_shader_frag, glyph_attr_names, 4
 	}
 };
 
+/// @brief Data shader used instead of shader_infos[SHADER_DATA] without GL_ARB_shader_draw_parameters.
+static const ShaderInfo data_fallback_info = {
+	"data", source_data_fallback_shader_vert, source_data_fallback_shader_frag, data_attr_names, 2
+};
+
 
 // List of used shaders.
 Shader *shaders[SHADERNAME_SIZE];
 
+/// @brief Name of each uniform in the sources.
+static const char *uniform_names[SHADERUNIFORM_SIZE] = {
+	[UNIFORM_TRANSPARENCY] = "transparency",
+	[UNIFORM_FRAG_COLOR] = "frag_color",
+	[UNIFORM_LIMITS] = "limits",
+	[UNIFORM_RECT] = "rect",
+	[UNIFORM_MARKER_SIZE] = "marker_size",
+	[UNIFORM_FADE] = "fade",
+	[UNIFORM_COLORS] = "colors"
+};
+
+
+/// @brief Checks if the shaders can read the index of the draw in a multi draw.
+/// @return true if the driver supports GL_ARB_shader_draw_parameters.
+/// @note Must be called after the initialization of GLEW. Without the extension, the data shader
+/// takes the color of a curve as a uniform and the ranges of a multi draw are drawn one by one.
+bool shader_has_draw_id() {
+	return GLEW_ARB_shader_draw_parameters;
+}
 
 /// @brief Returns the sources of a shader.
 /// @param shader The constants that name the shader from which to get the sources.
@@ -147,6 +290,7 @@ Shader *shaders[SHADERNAME_SIZE];
 /// @param vert A variable to store a const pointer ot the vertex shader source.
 /// @param frag A variable to store a const pointer ot the fragment shader source.
 /// @return false if the name don't describe a known shader.
+/// @note The sources of the data shader depend on shader_has_draw_id.
 bool shader_get_sources(const ShaderName shader, const char **name, const char **vert,
 const char **frag, const char ***attr_names, int *n) {
     if (shader < 0 || shader >= SHADERNAME_SIZE) {
@@ -155,11 +299,12 @@ const char **frag, const char ***attr_names, int *n) {
 			"Unable to get the shader sources.\n", shader);
         return false;
     }
-    *name = shader_infos[shader].name;
-    *vert = shader_infos[shader].vert;
-    *frag = shader_infos[shader].frag;
-	*attr_names = shader_infos[shader].attr_names;
-	*n = shader_infos[shader].n;
+	const ShaderInfo *info = shader == SHADER_DATA && !shader_has_draw_id() ? &data_fallback_info : shader_infos+shader;
+    *name = info->name;
+    *vert = info->vert;
+    *frag = info->frag;
+	*attr_names = info->attr_names;
+	*n = info->n;
     return true;
 }
 
@@ -279,6 +424,11 @@ const char *attr_names[], const int n) {
 		free(char_error);
 		goto SHADER_LINK_ERROR;
 	}
+
+	// Resolves the uniforms once, so that no string lookup is done while rendering.
+	for (int i = 0; i < SHADERUNIFORM_SIZE; ++i) {
+		shader->uniforms[i] = glGetUniformLocation(shader->prog_id, uniform_names[i]);
+	}
 	return shader;
 
 	// Error cases.
@@ -315,15 +465,10 @@ void shader_use(Shader *shader) {
 	else glUseProgram(0);
 }
 
-/// @brief Do a call to glGetUniformLocation.
-/// @param shader The shader from where to get the uniform location.
-/// @param str The uniform name from who to get the uniform location
-/// @return The location of the uniform variable, -1 if the resource wasn't found.
-int shader_uniform_location(Shader *shader, const char *str) {
-	int uniform_location = glGetUniformLocation(shader->prog_id, str);
-	if (uniform_location == -1) {
-		fprintf(stderr, "[ARGUS]: error: '%s' uniform variable couldn't be found in the shader !"
-						" The rendering process might produce unxepected results.", str);
-	}
-	return uniform_location;
+/// @brief Returns the location of a uniform, resolved when the shader was created.
+/// @param shader The shader which uses the uniform.
+/// @param uniform The uniform to locate.
+/// @return The location of the uniform, or -1 if the shader doesn't use it.
+GLint shader_uniform(Shader *shader, ShaderUniform uniform) {
+	return shader->uniforms[uniform];
 }
@@ -8,23 +8,42 @@
 /// @brief List of constants that represents each shader.
 typedef enum {
 	SHADER_SHAPE,
-	SHADER_TEXT,
 	SHADER_CURVE,
+	SHADER_DATA,
+	SHADER_SCATTER,
 	SHADER_TEXTURE,
+	SHADER_GLYPH,
 	SHADERNAME_SIZE
 } ShaderName;
 
+/// @enum ShaderUniform
+/// @brief List of constants that represents each uniform used by the shaders.
+typedef enum {
+	UNIFORM_TRANSPARENCY,	///< float transparency, shape shader.
+	UNIFORM_FRAG_COLOR,		///< vec3 frag_color, curve, scatter and fallback data shaders.
+	UNIFORM_LIMITS,			///< vec4 limits, data and scatter shaders.
+	UNIFORM_RECT,			///< vec4 rect, data and scatter shaders.
+	UNIFORM_MARKER_SIZE,	///< vec2 marker_size, scatter shader.
+	UNIFORM_FADE,			///< float fade, texture shader.
+	UNIFORM_COLORS,			///< vec3 colors[], glyph shader.
+	SHADERUNIFORM_SIZE
+} ShaderUniform;
+
 /// @struct Shader
 /// @brief Used to store an OpenGL shader.
 typedef struct {
 	GLuint vert_id;	///< Vertex shader id.
 	GLuint frag_id;	///< Fragment shader id.
 	GLuint prog_id;	///< Shader program id.
+	GLint uniforms[SHADERUNIFORM_SIZE];	///< Location of each uniform, -1 if the shader doesn't use it.
 } Shader;
 
 // List of used shaders.
 extern Shader *shaders[SHADERNAME_SIZE];
 
+// Checks if the shaders can read the index of the draw in a multi draw.
+bool shader_has_draw_id();
+
 // Returns the sources of a shader.
 bool shader_get_sources(const ShaderName shader, const char **name, const char **vert, 
 	const char **frag, const char ***attr_names, int *n);
@@ -39,5 +58,5 @@ void shader_free(Shader **p_shader);
 // Binds a shader.
 void shader_use(Shader *shader);
 
-// Do a call to glGetUniformLocation.
-int shader_uniform_location(Shader *shader, const char *str);
+// Returns the location of a uniform, resolved when the shader was created.
+GLint shader_uniform(Shader *shader, ShaderUniform uniform);
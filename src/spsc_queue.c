@@ -0,0 +1,139 @@
+#include "spsc_queue.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/// @brief Allocates an SPSCQueue that can store at least cap values.
+/// @param cap The minimal capacity of the queue.
+/// @return The initialized queue.
+SPSCQueue *spscqueue_create(size_t cap) {
+	if (cap <= 0) {
+		fprintf(stderr, "[ARGUS]: error: SPSCQueue capacity must be greater than 0. Given capacity: %ld\n", cap);
+		return NULL;
+	}
+
+	// Malloc the SPSCQueue struct.
+	SPSCQueue *queue = aligned_alloc(alignof(SPSCQueue), sizeof(SPSCQueue));
+	if (!queue) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the SPSCQueue structure.\n");
+		return NULL;
+	}
+	size_t pow2 = 1;
+	while (pow2 < cap) pow2 <<= 1;
+	queue->cap = pow2;
+	atomic_init(&queue->head, 0);
+	atomic_init(&queue->tail, 0);
+
+	// Malloc the inner buffer.
+	queue->data = malloc(sizeof(float) * queue->cap);
+	if (!queue->data) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the SPSCQueue's data buffer.\n");
+		free(queue);
+		return NULL;
+	}
+	return queue;
+}
+
+/// @brief Frees the memory allocated for an SPSCQueue.
+/// @param p_queue A pointer to the pointer of the SPSCQueue to be freed. Cannot be NULL.
+/// @note After freeing, the pointer *p_queue is set to NULL to avoid double-free.
+/// @note No thread must be using the queue when it is freed.
+void spscqueue_free(SPSCQueue **p_queue) {
+	SPSCQueue *queue = *p_queue;
+	if (!queue) return;
+	free(queue->data);
+	free(queue);
+	*p_queue = NULL;
+}
+
+
+/// @brief Pushes values at the end of the queue. Producer side.
+/// @param queue The queue where to store the values.
+/// @param data The values to store.
+/// @param n The number of values in data.
+/// @return The number of values actually pushed. Lower than n if the queue is full.
+/// @note Only one thread at a time may call this function on a given queue.
+size_t spscqueue_push(SPSCQueue *queue, const float *data, size_t n) {
+	const size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	const size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+	const size_t space = queue->cap - (tail - head);
+	if (n > space) n = space;
+	if (!n) return 0;
+
+	// Copies the values in at most two parts if the end of the buffer is reached.
+	const size_t id = tail & (queue->cap - 1);
+	const size_t first = n < queue->cap - id ? n : queue->cap - id;
+	memcpy(queue->data + id, data, first * sizeof(float));
+	memcpy(queue->data, data + first, (n - first) * sizeof(float));
+	atomic_store_explicit(&queue->tail, tail + n, memory_order_release);
+	return n;
+}
+
+/// @brief Pops values from the front of the queue. Consumer side.
+/// @param queue The queue from which to read the values.
+/// @param data The buffer where to store the values read.
+/// @param n The maximal number of values to read. data must be at least n values long.
+/// @return The number of values actually read.
+/// @note Only one thread at a time may call this function on a given queue.
+size_t spscqueue_pop(SPSCQueue *queue, float *data, size_t n) {
+	const size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	const size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	const size_t size = tail - head;
+	if (n > size) n = size;
+	if (!n) return 0;
+
+	// Copies the values in at most two parts if the end of the buffer is reached.
+	const size_t id = head & (queue->cap - 1);
+	const size_t first = n < queue->cap - id ? n : queue->cap - id;
+	memcpy(data, queue->data + id, first * sizeof(float));
+	memcpy(data + first, queue->data, (n - first) * sizeof(float));
+	atomic_store_explicit(&queue->head, head + n, memory_order_release);
+	return n;
+}
+
+/// @brief Returns the number of values that can be read.
+/// @param queue The queue to get the size from.
+/// @return The number of values stored in the queue.
+/// @note The result is only exact when called from the consumer thread.
+size_t spscqueue_size(SPSCQueue *queue) {
+	const size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	const size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	return tail - head;
+}
+
+/// @brief Returns the number of values that can be written.
+/// @param queue The queue to get the space from.
+/// @return The number of free slots in the queue.
+/// @note The result is only exact when called from the producer thread.
+size_t spscqueue_space(SPSCQueue *queue) {
+	const size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	const size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+	return queue->cap - (tail - head);
+}
+
+/// @brief Gets a writable span at the end of the queue. Producer side.
+/// @param queue The queue where to write.
+/// @param n The number of values to write. Set to the length of the returned span, which can be lower.
+/// @return The span where the values must be written, before being published with spscqueue_commit.
+/// @note A span never wraps around the end of the buffer, so the values may need two reservations.
+/// @note Only one thread at a time may call this function on a given queue.
+float *spscqueue_reserve(SPSCQueue *queue, size_t *n) {
+	const size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	const size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+	const size_t id = tail & (queue->cap - 1);
+	size_t len = queue->cap - (tail - head);
+	if (len > queue->cap - id) len = queue->cap - id;
+	if (*n > len) *n = len;
+	return queue->data + id;
+}
+
+/// @brief Publishes the values written in the reserved span. Producer side.
+/// @param queue The queue where the values were written.
+/// @param n The number of values written. Must be lower or equal to the length of the reserved span.
+/// @note Only one thread at a time may call this function on a given queue.
+void spscqueue_commit(SPSCQueue *queue, size_t n) {
+	const size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	atomic_store_explicit(&queue->tail, tail + n, memory_order_release);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <stdalign.h>
+
+
+/// @struct SPSCQueue
+/// @brief A lock-free queue with a single producer thread and a single consumer thread.
+/// @note The capacity is always rounded up to a power of two.
+typedef struct {
+	float *data;	///< The inner buffer that contains the data.
+	size_t cap;		///< The capacity of the queue (the length of data).
+	alignas(64) atomic_size_t head;	///< Total number of values read. Written by the consumer.
+	alignas(64) atomic_size_t tail;	///< Total number of values written. Written by the producer.
+} SPSCQueue;
+
+
+// Allocates an SPSCQueue that can store at least cap values.
+SPSCQueue *spscqueue_create(size_t cap);
+
+// Frees the memory allocated for an SPSCQueue.
+void spscqueue_free(SPSCQueue **p_queue);
+
+
+// Pushes values at the end of the queue. Producer side.
+size_t spscqueue_push(SPSCQueue *queue, const float *data, size_t n);
+
+// Pops values from the front of the queue. Consumer side.
+size_t spscqueue_pop(SPSCQueue *queue, float *data, size_t n);
+
+// Returns the number of values that can be read.
+size_t spscqueue_size(SPSCQueue *queue);
+
+// Returns the number of values that can be written.
+size_t spscqueue_space(SPSCQueue *queue);
+
+// Gets a writable span at the end of the queue. Producer side.
+float *spscqueue_reserve(SPSCQueue *queue, size_t *n);
+
+// Publishes the values written in the reserved span. Producer side.
+void spscqueue_commit(SPSCQueue *queue, size_t n);
@@ -0,0 +1,163 @@
+#include "text_batch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "string.h"
+
+
+
+/// @brief Creates an empty text batch.
+/// @return The created batch, or NULL in case of an error.
+/// @note The VAO is only created by the first upload, so a batch can be used to store characters on the CPU.
+TextBatch *textbatch_create(void) {
+	TextBatch *batch = malloc(sizeof(TextBatch));
+	if (!batch) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc a TextBatch!\n");
+		return NULL;
+	}
+	*batch = (TextBatch){NULL, NULL, NULL, 0, 0, NULL, 0};
+	return batch;
+}
+
+/// @brief Frees the memory allocated for a TextBatch.
+/// @param p_batch A pointer to the pointer of the TextBatch to be freed. Cannot be NULL.
+/// @note After freeing, the pointer *p_batch is set to NULL to avoid double-free.
+void textbatch_free(TextBatch **p_batch) {
+	TextBatch *batch = *p_batch;
+	if (!batch) return;
+	vao_free_instanced(&batch->vao);
+	free(batch->rects);
+	free(batch->cells);
+	free(batch->styles);
+	free(batch);
+	*p_batch = NULL;
+}
+
+/// @brief Removes all the characters of a batch.
+/// @param batch The batch to clear.
+/// @note The buffers and the VAO are kept to be filled again.
+void textbatch_clear(TextBatch *batch) {
+	batch->size = 0;
+}
+
+/// @brief Grows the buffers of a batch so that n more characters can be added.
+/// @param batch The batch to grow.
+/// @param n The number of characters to add.
+/// @return false if there was an error.
+static bool textbatch_reserve(TextBatch *batch, size_t n) {
+	if (batch->size + n <= batch->cap) return true;
+	size_t cap = batch->cap ? 2*batch->cap : 64;
+	while (cap < batch->size + n) cap *= 2;
+	float *rects = realloc(batch->rects, 4*cap*sizeof(float));
+	if (rects) batch->rects = rects;
+	float *cells = realloc(batch->cells, cap*sizeof(float));
+	if (cells) batch->cells = cells;
+	float *styles = realloc(batch->styles, 2*cap*sizeof(float));
+	if (styles) batch->styles = styles;
+	if (!rects || !cells || !styles) {
+		fprintf(stderr, "[ARGUS]: error: unable to realloc the buffers of a TextBatch!\n");
+		return false;
+	}
+	batch->cap = cap;
+	return true;
+}
+
+/// @brief Sets the style of the last characters of a batch.
+/// @param batch The batch to modify.
+/// @param first The index of the first character to set.
+/// @param vertical true if the characters are vertical.
+/// @param color The index of the color of the characters.
+static void textbatch_set_style(TextBatch *batch, size_t first, bool vertical, int color) {
+	for (size_t i = first; i < batch->size; ++i) {
+		batch->styles[2*i] = vertical;
+		batch->styles[2*i+1] = color;
+	}
+}
+
+/// @brief Adds a text laid out in a given rect to a batch.
+/// @param batch The batch to fill.
+/// @param glyphs The glyphs set to use.
+/// @param rect The rect that will contains the text.
+/// @param text The text to render.
+/// @param screen_ratio The ratio of the window (w/h).
+/// @param vertical true to lay the text out vertically.
+/// @param color The index of the color of the text in the palette given at render time.
+/// @return false if there was an error.
+bool textbatch_add(TextBatch *batch, Glyphs *glyphs, Rect rect, const char *text,
+float screen_ratio, bool vertical, int color) {
+	if (!textbatch_reserve(batch, utf8_len(text))) return false;
+	const size_t first = batch->size;
+	batch->size += glyphs_write_instances(glyphs, rect, text, screen_ratio, vertical,
+		batch->rects+4*first, batch->cells+first);
+	textbatch_set_style(batch, first, vertical, color);
+	return true;
+}
+
+/// @brief Adds a cached text layout, translated to a given position, to a batch.
+/// @param batch The batch to fill.
+/// @param layout The layout to add.
+/// @param x The x position of the rect the layout was made for.
+/// @param y The y position of the rect the layout was made for.
+/// @param color The index of the color of the text in the palette given at render time.
+/// @return false if there was an error.
+bool textbatch_add_layout(TextBatch *batch, const GlyphsLayout *layout, float x, float y, int color) {
+	if (!textbatch_reserve(batch, layout->n)) return false;
+	const size_t first = batch->size;
+	for (int i = 0; i < layout->n; ++i) {
+		batch->rects[4*(first+i)]	= x + layout->rects[4*i];
+		batch->rects[4*(first+i)+1]	= y + layout->rects[4*i+1];
+		batch->rects[4*(first+i)+2]	= layout->rects[4*i+2];
+		batch->rects[4*(first+i)+3]	= layout->rects[4*i+3];
+	}
+	memcpy(batch->cells+first, layout->cells, layout->n*sizeof(float));
+	batch->size += layout->n;
+	textbatch_set_style(batch, first, layout->vertical, color);
+	return true;
+}
+
+/// @brief Adds all the characters of another batch to a batch.
+/// @param batch The batch to fill.
+/// @param other The batch to copy the characters from. Can be NULL.
+/// @return false if there was an error.
+bool textbatch_append(TextBatch *batch, const TextBatch *other) {
+	if (!other || !other->size) return true;
+	if (!textbatch_reserve(batch, other->size)) return false;
+	memcpy(batch->rects+4*batch->size, other->rects, 4*other->size*sizeof(float));
+	memcpy(batch->cells+batch->size, other->cells, other->size*sizeof(float));
+	memcpy(batch->styles+2*batch->size, other->styles, 2*other->size*sizeof(float));
+	batch->size += other->size;
+	return true;
+}
+
+/// @brief Uploads the characters of a batch into its VAO.
+/// @param batch The batch to upload.
+/// @return false if there was an error.
+/// @note The VAO holds a single quad shared by the instances, and is only created again when it is too small.
+bool textbatch_upload(TextBatch *batch) {
+	if (!batch->size) return true;
+	if (batch->vao && batch->vao_cap < batch->size) vao_free_instanced(&batch->vao);
+	if (!batch->vao) {
+		float quad[8] = {0,0, 1,0, 0,1, 1,1};
+		void *shared_data = quad;
+		int shared_sizes = 2;
+		int shared_gl_types = GL_FLOAT;
+		int instance_sizes[3] = {4,1,2};
+		int instance_gl_types[3] = {GL_FLOAT,GL_FLOAT,GL_FLOAT};
+		batch->vao = vao_create_instanced_dynamic(
+			&shared_data, &shared_sizes, &shared_gl_types, 4, 1,
+			instance_sizes, instance_gl_types, batch->cap, 3
+		);
+		if (!batch->vao) {
+			fprintf(stderr, "[ARGUS]: error: unable to create the InstancedVAO of a TextBatch!\n");
+			return false;
+		}
+		batch->vao_cap = batch->cap;
+	}
+	VBO *vbo = batch->vao->vbo_instanced;
+	vbo_update(vbo, 0, 4*batch->size*sizeof(float), batch->rects);
+	vbo_update(vbo, 4*batch->vao_cap*sizeof(float), batch->size*sizeof(float), batch->cells);
+	vbo_update(vbo, 5*batch->vao_cap*sizeof(float), 2*batch->size*sizeof(float), batch->styles);
+	return true;
+}
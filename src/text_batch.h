@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "glyphs.h"
+#include "structs.h"
+#include "vao.h"
+
+
+// Number of colors in the palette of a text batch, as declared in the glyph shader.
+#define TEXTBATCH_COLORS 4
+
+/// @struct TextBatch
+/// @brief A list of characters drawn together as instances of a single quad.
+/// @note Each character stores its rect, its atlas cell and its style, the index of its
+/// color in the palette given at render time and whether it is vertical.
+typedef struct {
+	float *rects;		///< The rect (x, y, w, h) of each character.
+	float *cells;		///< The atlas cell of each character.
+	float *styles;		///< The style (vertical, color index) of each character.
+	size_t size;		///< The number of characters.
+	size_t cap;			///< The number of characters the buffers can hold.
+	InstancedVAO *vao;	///< The VAO the characters were uploaded into, or NULL.
+	size_t vao_cap;		///< The number of characters the VAO can hold.
+} TextBatch;
+
+
+// Creates an empty text batch.
+TextBatch *textbatch_create(void);
+
+// Frees the memory allocated for a TextBatch.
+void textbatch_free(TextBatch **p_batch);
+
+// Removes all the characters of a batch.
+void textbatch_clear(TextBatch *batch);
+
+
+// Adds a text laid out in a given rect to a batch.
+bool textbatch_add(TextBatch *batch, Glyphs *glyphs, Rect rect, const char *text,
+	float screen_ratio, bool vertical, int color);
+
+// Adds a cached text layout, translated to a given position, to a batch.
+bool textbatch_add_layout(TextBatch *batch, const GlyphsLayout *layout, float x, float y, int color);
+
+// Adds all the characters of another batch to a batch.
+bool textbatch_append(TextBatch *batch, const TextBatch *other);
+
+
+// Uploads the characters of a batch into its VAO.
+bool textbatch_upload(TextBatch *batch);
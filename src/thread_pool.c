@@ -0,0 +1,127 @@
+#include "thread_pool.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+
+/// @brief Runs items of the current task until there is none left.
+/// @param pool The pool running the task.
+/// @param task The function to run for each item.
+/// @param ctx The context given to the task.
+/// @param n The number of items of the task.
+static void threadpool_work(ThreadPool *pool, void (*task)(void *ctx, size_t id), void *ctx, size_t n) {
+	size_t id;
+	while ((id = atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed)) < n) task(ctx, id);
+}
+
+/// @brief Main function of the worker threads.
+/// @param arg The pool of the worker.
+/// @return NULL.
+static void *threadpool_worker(void *arg) {
+	ThreadPool *pool = arg;
+	uint64_t seen = 0;
+	pthread_mutex_lock(&pool->mutex);
+	while (true) {
+		while (!pool->stop && pool->generation == seen) pthread_cond_wait(&pool->start, &pool->mutex);
+		if (pool->stop) break;
+		seen = pool->generation;
+		void (*task)(void *ctx, size_t id) = pool->task;
+		void *ctx = pool->ctx;
+		const size_t n = pool->task_size;
+		pthread_mutex_unlock(&pool->mutex);
+
+		threadpool_work(pool, task, ctx, n);
+
+		pthread_mutex_lock(&pool->mutex);
+		if (!--pool->active) pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+
+/// @brief Creates a pool of n worker threads.
+/// @param n The number of worker threads. The thread calling threadpool_run works too.
+/// @return The created pool, or NULL if there was an error.
+ThreadPool *threadpool_create(size_t n) {
+	ThreadPool *pool = malloc(sizeof(ThreadPool));
+	if (!pool) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the ThreadPool structure.\n");
+		return NULL;
+	}
+	pool->threads = malloc(n*sizeof(pthread_t));
+	if (n && !pool->threads) {
+		fprintf(stderr, "[ARGUS]: error: failed to allocate memory for the ThreadPool's threads.\n");
+		free(pool);
+		return NULL;
+	}
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	pool->size = 0;
+	pool->generation = 0;
+	pool->active = 0;
+	pool->stop = false;
+	pool->task = NULL;
+	pool->ctx = NULL;
+	pool->task_size = 0;
+	atomic_init(&pool->next, 0);
+
+	// Starts the workers.
+	for (size_t i = 0; i < n; ++i) {
+		if (pthread_create(pool->threads+i, NULL, threadpool_worker, pool)) {
+			fprintf(stderr, "[ARGUS]: error: unable to create a worker thread!\n");
+			threadpool_free(&pool);
+			return NULL;
+		}
+		++pool->size;
+	}
+	return pool;
+}
+
+/// @brief Stops the workers and frees the memory allocated for a ThreadPool.
+/// @param p_pool A pointer to the pointer of the ThreadPool to be freed. Cannot be NULL.
+/// @note After freeing, the pointer *p_pool is set to NULL to avoid double-free.
+/// @note Must not be called while a task is running.
+void threadpool_free(ThreadPool **p_pool) {
+	ThreadPool *pool = *p_pool;
+	if (!pool) return;
+	pthread_mutex_lock(&pool->mutex);
+	pool->stop = true;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->mutex);
+	for (size_t i = 0; i < pool->size; ++i) pthread_join(pool->threads[i], NULL);
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->start);
+	pthread_mutex_destroy(&pool->mutex);
+	free(pool->threads);
+	free(pool);
+	*p_pool = NULL;
+}
+
+
+/// @brief Runs the n items of a task on the pool and the calling thread, and waits for them to end.
+/// @param pool The pool to use.
+/// @param task The function to run for each item. It gets ctx and the id of the item.
+/// @param ctx The context given to the task.
+/// @param n The number of items.
+/// @note Returning from this function acts as a barrier: everything done by the items 
+/// is visible to the calling thread, and to the items of the next task.
+void threadpool_run(ThreadPool *pool, void (*task)(void *ctx, size_t id), void *ctx, size_t n) {
+	pthread_mutex_lock(&pool->mutex);
+	pool->task = task;
+	pool->ctx = ctx;
+	pool->task_size = n;
+	pool->active = pool->size;
+	atomic_store_explicit(&pool->next, 0, memory_order_relaxed);
+	++pool->generation;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->mutex);
+
+	threadpool_work(pool, task, ctx, n);
+
+	pthread_mutex_lock(&pool->mutex);
+	while (pool->active) pthread_cond_wait(&pool->done, &pool->mutex);
+	pthread_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+
+/// @struct ThreadPool
+/// @brief A set of worker threads that run the items of a task in parallel.
+/// @note The items are taken one by one from a shared atomic counter, so a worker that ends 
+/// its items early takes the ones the others haven't started, whatever their cost.
+typedef struct {
+	pthread_t *threads;		///< The worker threads.
+	size_t size;			///< The number of worker threads.
+	pthread_mutex_t mutex;	///< Protects the fields below, apart from next.
+	pthread_cond_t start;	///< Signaled when a new task is available.
+	pthread_cond_t done;	///< Signaled when the last worker ends the current task.
+	uint64_t generation;	///< Id of the current task.
+	size_t active;			///< Number of workers still running the current task.
+	bool stop;				///< true if the workers must exit.
+	void (*task)(void *ctx, size_t id);	///< The function run for each item.
+	void *ctx;				///< The context given to the task.
+	size_t task_size;		///< The number of items of the task.
+	atomic_size_t next;		///< The next item to run.
+} ThreadPool;
+
+
+// Creates a pool of n worker threads.
+ThreadPool *threadpool_create(size_t n);
+
+// Stops the workers and frees the memory allocated for a ThreadPool.
+void threadpool_free(ThreadPool **p_pool);
+
+
+// Runs the n items of a task on the pool and the calling thread, and waits for them to end.
+void threadpool_run(ThreadPool *pool, void (*task)(void *ctx, size_t id), void *ctx, size_t n);
@@ -0,0 +1,297 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "updater.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "curve.h"
+#include "thread_pool.h"
+#include "deadline_heap.h"
+#include "wakeup.h"
+
+
+
+/// @struct UpdateEntry
+/// @brief The schedule of the updates of a curve.
+typedef struct {
+	Curve *curve;		///< The curve to update.
+	Graph *graph;		///< The graph of the curve.
+	double period;		///< Time between two updates, in nanoseconds.
+	double timestep;	///< Timestep given to the update function.
+	uint64_t ticks;		///< Number of updates passed, done or dropped.
+	uint64_t done;		///< Number of updates done.
+	uint64_t max;		///< Number of updates to do.
+	uint64_t steps;		///< Number of updates to do in the current batch.
+} UpdateEntry;
+
+
+// Update thread state.
+static pthread_t thread;				///< The update thread.
+static atomic_bool running = false;		///< true while the update thread must run.
+static atomic_uint_fast64_t iteration;	///< Number of iterations done.
+
+// Update parameters, only read by the update thread while it runs.
+static UpdateEntry *entries;	///< The schedules of the curves to update.
+static size_t entries_size;		///< The number of curves to update.
+static DeadlineHeap *deadlines;	///< The next deadline of each curve, the earliest first.
+static size_t *batch;			///< The ids of the curves due in the current batch.
+static ThreadPool *pool;		///< The pool used to update the curves in parallel, or NULL.
+static uint64_t start_time;		///< Time at which the updates started.
+static uint64_t max_catchup;	///< Max number of late updates done at once.
+
+
+
+/// @brief Gets the time of the monotonic clock in nanoseconds.
+/// @return The current time.
+static uint64_t updater_now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec*1000000000ull + time.tv_nsec;
+}
+
+/// @brief Sleeps until a given time of the monotonic clock, or for at most 10ms.
+/// @param deadline The time to wake up at, in nanoseconds.
+/// @note The sleep is bounded so that the thread can notice quickly that it must stop.
+static void updater_sleep_until(uint64_t deadline) {
+	const uint64_t now = updater_now();
+	if (deadline <= now) return;
+	if (deadline - now > 10000000ull) deadline = now + 10000000ull;
+	const struct timespec time = {deadline/1000000000ull, deadline%1000000000ull};
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, NULL);
+}
+
+/// @brief Updates a curve, waiting for the render thread to empty its queues if needed.
+/// @param entry The schedule of the curve to update.
+/// @return false if the thread was stopped while waiting.
+static bool updater_update_curve(const UpdateEntry *entry) {
+	while (!curve_update_async(entry->curve, entry->timestep)) {
+		if (!atomic_load(&running)) return false;
+		wakeup_notify(&entry->graph->dirty);
+		updater_sleep_until(updater_now() + 1000000ull);
+	}
+	return true;
+}
+
+/// @brief Gets the time of the next update of a curve.
+/// @param entry The schedule of the curve.
+/// @return The deadline of the update, in nanoseconds.
+static inline uint64_t updater_deadline(const UpdateEntry *entry) {
+	return start_time + (uint64_t)(entry->ticks*entry->period);
+}
+
+/// @brief Updates one curve of the batch several times in a row. Task run by the thread pool.
+/// @param ctx Unused.
+/// @param id The id of the curve in the batch.
+static void updater_task(void *ctx, size_t id) {
+	(void)ctx;
+	const UpdateEntry *entry = &entries[batch[id]];
+	for (uint64_t i = 0; i < entry->steps; ++i) {
+		if (!updater_update_curve(entry)) return;
+	}
+}
+
+/// @brief Main function of the update thread.
+/// @param arg Unused.
+/// @return NULL.
+/// @note Update k of a curve is due at start + k/frequency of the curve. The thread sleeps until
+/// the earliest deadline, then runs only the curves that are due. Each one runs all its due updates, 
+/// in a batch when the thread is late, so the rate doesn't drift. At most max_catchup updates 
+/// are run at once, the older ones are dropped.
+static void *updater_run(void *arg) {
+	(void)arg;
+	const Deadline *next;
+	while (atomic_load(&running) && (next = deadlineheap_top(deadlines))) {
+		updater_sleep_until(next->time);
+		const uint64_t now = updater_now();
+
+		// Takes the curves that are due out of the heap.
+		size_t batch_size = 0;
+		while ((next = deadlineheap_top(deadlines)) && next->time <= now) {
+			UpdateEntry *entry = &entries[next->id];
+			batch[batch_size++] = next->id;
+			deadlineheap_pop(deadlines);
+
+			// Drops the updates that exceed the catch-up cap.
+			const uint64_t due = (now - start_time)/entry->period + 1;
+			entry->steps = due > entry->ticks ? due - entry->ticks : 1;
+			if (entry->steps > max_catchup) {
+				entry->ticks += entry->steps - max_catchup;
+				entry->steps = max_catchup;
+			}
+			if (entry->steps > entry->max - entry->done) entry->steps = entry->max - entry->done;
+		}
+		if (!batch_size) continue;
+
+		// Updates the curves, in parallel if there is a pool.
+		if (pool) threadpool_run(pool, updater_task, NULL, batch_size);
+		else for (size_t i = 0; i < batch_size; ++i) updater_task(NULL, i);
+		if (!atomic_load(&running)) break;
+
+		// Schedules the next update of the curves that aren't done.
+		uint64_t count = atomic_load(&iteration);
+		for (size_t i = 0; i < batch_size; ++i) {
+			UpdateEntry *entry = &entries[batch[i]];
+			entry->ticks += entry->steps;
+			entry->done += entry->steps;
+			wakeup_notify(&entry->graph->dirty);
+			if (entry->done > count) count = entry->done;
+			if (entry->done < entry->max) deadlineheap_push(deadlines, updater_deadline(entry), batch[i]);
+		}
+		atomic_store(&iteration, count);
+	}
+	return NULL;
+}
+
+/// @brief Frees the schedules of the curves.
+static void updater_clear() {
+	threadpool_free(&pool);
+	deadlineheap_free(&deadlines);
+	free(entries);
+	free(batch);
+	entries = NULL;
+	batch = NULL;
+	entries_size = 0;
+}
+
+
+/// @brief Lists the curves of the graphs to update, with their own rate, and creates the pool.
+/// @param graphs The graphs to update.
+/// @param n The number of graphs.
+/// @param f The number of updates per second of the curves without their own frequency.
+/// @param dt The timestep given to the update functions of the curves without their own timestep.
+/// @param duration The simulated duration. Each curve is updated duration/timestep times.
+/// @param threads The number of threads updating the curves.
+/// @return false if there was an error.
+static bool updater_prepare(Graph **graphs, size_t n, double f, double dt, double duration, int threads) {
+	size_t total = 0;
+	for (size_t i = 0; i < n; ++i) total += graphs[i]->curves->size;
+	if (!total) return true;
+	entries = malloc(total*sizeof(UpdateEntry));
+	batch = malloc(total*sizeof(size_t));
+	deadlines = deadlineheap_create(total);
+	if (!entries || !batch || !deadlines) {
+		fprintf(stderr, "[ARGUS]: error: unable to malloc the schedules of the curves to update!\n");
+		updater_clear();
+		return false;
+	}
+	start_time = updater_now();
+	for (size_t i = 0; i < n; ++i) {
+		Graph *graph = graphs[i];
+		for (size_t j = 0; j < graph->curves->size; ++j) {
+			Curve *curve = graph->curves->data[j];
+			if (!curve->update && !curve->batch_update) continue;
+			const double frequency = curve->update_frequency > 0 ? curve->update_frequency : f;
+			const double timestep = curve->update_timestep > 0 ? curve->update_timestep : dt;
+			if (frequency <= 0 || timestep <= 0 || duration/timestep < 1) continue;
+			entries[entries_size] = (UpdateEntry){curve, graph, 1e9/frequency, timestep, 0, 0, duration/timestep, 0};
+			deadlineheap_push(deadlines, start_time, entries_size);
+			++entries_size;
+		}
+	}
+
+	// Creates the pool. The calling thread works too, so it needs one thread less.
+	if (threads > 1 && entries_size > 1) {
+		const size_t workers = (size_t)threads-1 < entries_size-1 ? (size_t)threads-1 : entries_size-1;
+		pool = threadpool_create(workers);
+		if (!pool) {
+			updater_clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+/// @brief Starts the thread that updates the curves of the graphs.
+/// @param graphs The graphs to update. They must not change until updater_stop is called.
+/// @param n The number of graphs.
+/// @param f The number of updates per second of the curves without their own frequency.
+/// @param dt The timestep given to the update functions of the curves without their own timestep.
+/// @param duration The simulated duration. Each curve is updated duration/timestep times.
+/// @param threads The number of threads updating the curves. With more than one, 
+/// the curves due at the same time are updated in parallel on a thread pool, and end with a barrier.
+/// @param catchup The maximal number of late updates run in a batch. Must be at least 1.
+/// @return false if there was an error.
+/// @note The curves are updated through their update queues, which are emptied by the render thread.
+bool updater_start(Graph **graphs, size_t n, double f, double dt, double duration, int threads, uint64_t catchup) {
+	if (atomic_load(&running)) {
+		fprintf(stderr, "[ARGUS]: error: the update thread is already running!\n");
+		return false;
+	}
+	max_catchup = catchup ? catchup : 1;
+	atomic_store(&iteration, 0);
+	if (!updater_prepare(graphs, n, f, dt, duration, threads)) return false;
+	if (!entries_size) {
+		updater_clear();
+		return true;
+	}
+	for (size_t i = 0; i < entries_size; ++i) curve_update_start(entries[i].curve);
+
+	// Starts the thread.
+	atomic_store(&running, true);
+	if (pthread_create(&thread, NULL, updater_run, NULL)) {
+		fprintf(stderr, "[ARGUS]: error: unable to create the update thread!\n");
+		atomic_store(&running, false);
+		updater_clear();
+		return false;
+	}
+	return true;
+}
+
+/// @brief Runs all the updates of one curve. Task run by the thread pool.
+/// @param ctx Unused.
+/// @param id The id of the curve to update.
+static void updater_task_all(void *ctx, size_t id) {
+	(void)ctx;
+	UpdateEntry *entry = &entries[id];
+	for (; entry->done < entry->max; ++entry->done) curve_update(entry->curve, entry->timestep);
+}
+
+/// @brief Runs all the updates of the curves of the graphs at once, without any pacing.
+/// @param graphs The graphs to update.
+/// @param n The number of graphs.
+/// @param dt The timestep given to the update functions of the curves without their own timestep.
+/// @param duration The simulated duration. Each curve is updated duration/timestep times.
+/// @param threads The number of threads updating the curves. With more than one, 
+/// the curves are updated in parallel on a thread pool.
+/// @return false if there was an error.
+/// @note The values are written directly in the buffers of the curves, so the curves 
+/// must not be shown or updated by another thread meanwhile.
+bool updater_fast_forward(Graph **graphs, size_t n, double dt, double duration, int threads) {
+	if (atomic_load(&running)) {
+		fprintf(stderr, "[ARGUS]: error: the update thread is already running!\n");
+		return false;
+	}
+
+	// The frequency doesn't matter here, it only needs to be valid.
+	atomic_store(&iteration, 0);
+	if (!updater_prepare(graphs, n, 1.0, dt, duration, threads)) return false;
+	if (pool) threadpool_run(pool, updater_task_all, NULL, entries_size);
+	else for (size_t i = 0; i < entries_size; ++i) updater_task_all(NULL, i);
+
+	// Counts the updates of the most updated curve.
+	uint64_t count = 0;
+	for (size_t i = 0; i < entries_size; ++i) {
+		if (entries[i].done > count) count = entries[i].done;
+	}
+	atomic_store(&iteration, count);
+	updater_clear();
+	return true;
+}
+
+/// @brief Stops the update thread and waits for it.
+/// @note Does nothing if the thread isn't running.
+void updater_stop() {
+	if (!atomic_load(&running)) return;
+	atomic_store(&running, false);
+	pthread_join(thread, NULL);
+	updater_clear();
+}
+
+/// @brief Returns the number of updates done by the most updated curve.
+/// @return The number of iterations.
+uint64_t updater_iteration() {
+	return atomic_load(&iteration);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+
+
+// Starts the thread that updates the curves of the graphs.
+bool updater_start(Graph **graphs, size_t n, double frequency, double timestep, double duration, int threads, uint64_t catchup);
+
+// Runs all the updates of the curves of the graphs at once, without any pacing.
+bool updater_fast_forward(Graph **graphs, size_t n, double timestep, double duration, int threads);
+
+// Stops the update thread and waits for it.
+void updater_stop();
+
+// Returns the number of updates done by the most updated curve.
+uint64_t updater_iteration();
@@ -16,6 +16,27 @@ int sizeFromGLType(int type) {
 	}
 }
 
+/// @brief Creates the OpenGL VAO of a VAO structure and links its VBO lists to it.
+/// @param vao The VAO structure, whose VBO is already created.
+/// @param sizes Lists of data vectors sizes.
+/// @param gl_types Lists of data types.
+/// @param type_sizes Lists of data types sizes.
+/// @param buffer_len Length of the data lists (number of vectors).
+/// @param n Number of lists.
+static void vao_link(VAO *vao, int* sizes, int* gl_types, int* type_sizes, size_t buffer_len, int n) {
+	size_t offset = 0;
+	glGenVertexArrays(1, &vao->vao_id);
+	vao_bind(vao);
+		vbo_bind(vao->vbo);
+			for (int i = 0; i < n; ++i) {
+				glVertexAttribPointer(i, sizes[i], gl_types[i], GL_FALSE, 0, (void*)(offset));
+				glEnableVertexAttribArray(i);
+				offset += sizes[i] * type_sizes[i] * buffer_len;
+			}
+		vbo_bind(NULL);
+	vao_bind(NULL);
+}
+
 /// @brief Constructs a VAO using the given parameters.
 /// @param data Arrays of vectors of data.
 /// @param sizes Lists of data vectors sizes.
@@ -45,21 +66,45 @@ VAO *vao_create(void** data, int* sizes, int* gl_types, size_t buffer_len, int n
 	}
 
 	// Creates the VAO and links the VBO to it.
-	size_t offset = 0;
-	glGenVertexArrays(1, &vao->vao_id);
-	vao_bind(vao);
-		vbo_bind(vao->vbo);
-			for (int i = 0; i < n; ++i) {
-				glVertexAttribPointer(i, sizes[i], gl_types[i], GL_FALSE, 0, (void*)(offset));
-				glEnableVertexAttribArray(i);
-				offset += sizes[i] * type_sizes[i] * buffer_len;
-			}
-		vbo_bind(NULL);
-	vao_bind(NULL);
+	vao_link(vao, sizes, gl_types, type_sizes, buffer_len, n);
 	return vao;
 
 }
 
+/// @brief Constructs an empty VAO whose content is meant to be updated frequently.
+/// @param sizes Lists of data vectors sizes.
+/// @param gl_types Lists of data types.
+/// @param buffer_len Length of the data lists (number of vectors).
+/// @param n Number of lists.
+/// @note The lists are stored one after the other in vao->vbo, list i starting at
+/// the byte sizes[0]*sizeof(gl_types[0])*buffer_len+...+sizes[i-1]*sizeof(gl_types[i-1])*buffer_len.
+/// @note The content is written with vbo_update on vao->vbo.
+/// @return The created VAO.
+VAO *vao_create_dynamic(int* sizes, int* gl_types, size_t buffer_len, int n) {
+
+	// Malloc the VAO structure.
+	VAO *vao = malloc(sizeof(VAO));
+	if (!vao) {
+		fprintf(stderr, "[ARGUS]: error: failed to malloc a VAO structure !\n");
+		return NULL;
+	}
+	vao->size = buffer_len;
+	
+	// Creates the VBO.
+	int type_sizes[n];
+	for (int i = 0; i < n; ++i) type_sizes[i] = sizeFromGLType(gl_types[i]);
+	vao->vbo = vbo_create_dynamic(sizes, type_sizes, buffer_len, n);
+	if (!vao->vbo) {
+		fprintf(stderr, "[ARGUS]: error: unable to create a VBO for a VAO !\n");
+		free(vao);
+		return NULL;
+	}
+
+	// Creates the VAO and links the VBO to it.
+	vao_link(vao, sizes, gl_types, type_sizes, buffer_len, n);
+	return vao;
+}
+
 /// @brief Frees the memory allocated for a VAO.
 /// @param p_vao A pointer to the pointer of the VAO to be freed. Cannot be NULL.
 /// @note After freeing, the pointer *p_vao is set to NULL to avoid double-free.
@@ -83,6 +128,48 @@ void vao_bind(VAO *vao) {
 }
 
 
+/// @brief Creates the OpenGL VAO of an InstancedVAO structure and links its VBO lists to it.
+/// @param vao The InstancedVAO structure, whose VBOs are already created.
+/// @param shared_sizes Lists of shared data vectors sizes.
+/// @param shared_gl_types Lists of shared data types.
+/// @param shared_type_sizes Lists of shared data types sizes.
+/// @param shared_buffer_len Length of the shared data lists (number of vectors).
+/// @param shared_n Number of shared lists.
+/// @param instance_sizes Lists of instance data vectors sizes.
+/// @param instance_gl_types Lists of instance data types.
+/// @param instance_type_sizes Lists of instance data types sizes.
+/// @param instance_buffer_len Length of the instance data lists (number of instances).
+/// @param instance_n Number of instance lists.
+/// @note The shared lists use the attributes 0 to shared_n-1, and the instance lists the next ones.
+static void vao_link_instanced(InstancedVAO *vao, 
+	int* shared_sizes, int* shared_gl_types, int* shared_type_sizes, size_t shared_buffer_len, int shared_n,
+	int* instance_sizes, int* instance_gl_types, int* instance_type_sizes, size_t instance_buffer_len, int instance_n
+) {
+	size_t offset = 0;
+	glGenVertexArrays(1, &vao->vao_id);
+	vao_bind_instanced(vao);
+
+		// Links the shader data.
+		vbo_bind(vao->vbo_shared);
+			for (int i = 0; i < shared_n; ++i) {
+				glVertexAttribPointer(i, shared_sizes[i], shared_gl_types[i], GL_FALSE, 0, (void*)(offset));
+				glEnableVertexAttribArray(i);
+				offset += shared_sizes[i] * shared_type_sizes[i] * shared_buffer_len;
+			}
+		
+		// Links the instance data.
+		vbo_bind(vao->vbo_instanced);
+			offset = 0;
+			for (int i = 0; i < instance_n; ++i) {
+				glVertexAttribPointer(i+shared_n, instance_sizes[i], instance_gl_types[i], GL_FALSE, 0, (void*)(offset));
+				glEnableVertexAttribArray(i+shared_n);
+				glVertexAttribDivisor(i+shared_n, 1);
+				offset += instance_sizes[i] * instance_type_sizes[i] * instance_buffer_len;
+			}
+		vbo_bind(NULL);
+	vao_bind_instanced(NULL);
+}
+
 /// @brief Constructs an InstancedVAO using the given parameters.
 /// @param shared_data Lists of shared data vectors sizes.
 /// @param shared_sizes Lists of shared data vectors sizes.
@@ -103,7 +190,7 @@ InstancedVAO *vao_create_instanced(
 ) {
 
 	// Malloc the VAO structure.
-	InstancedVAO *vao = malloc(sizeof(VAO));
+	InstancedVAO *vao = malloc(sizeof(InstancedVAO));
 	if (!vao) {
 		fprintf(stderr, "[ARGUS]: error: failed to malloc a VAO structure !\n");
 		return NULL;
@@ -132,29 +219,65 @@ InstancedVAO *vao_create_instanced(
 	}
 
 	// Creates the VAO and links the VBO to it.
-	size_t offset = 0;
-	glGenVertexArrays(1, &vao->vao_id);
-	vao_bind(vao);
+	vao_link_instanced(vao, 
+		shared_sizes, shared_gl_types, shared_type_sizes, shared_buffer_len, shared_n,
+		instance_sizes, instance_gl_types, instance_type_sizes, instance_buffer_len, instance_n
+	);
+	return vao;
+}
 
-		// Links the shader data.
-		vbo_bind(vao->vbo_shared);
-			for (int i = 0; i < shared_n; ++i) {
-				glVertexAttribPointer(i, shared_sizes[i], shared_gl_types[i], GL_FALSE, 0, (void*)(offset));
-				glEnableVertexAttribArray(i);
-				offset += shared_sizes[i] * shared_type_sizes[i] * shared_buffer_len;
-			}
-		
-		// Links the instance data.
-		vbo_bind(vao->vbo_instanced);
-			offset = 0;
-			for (int i = 0; i < instance_n; ++i) {
-				glVertexAttribPointer(i+shared_n, instance_sizes[i], instance_gl_types[i], GL_FALSE, 0, (void*)(offset));
-				glEnableVertexAttribArray(i);
-				glVertexAttribDivisor(i+shared_n, 1);
-				offset += instance_sizes[i] * instance_type_sizes[i] * instance_buffer_len;
-			}
-		vbo_bind(NULL);
-	vao_bind(NULL);
+/// @brief Constructs an InstancedVAO whose instance data is meant to be updated frequently.
+/// @param shared_data Lists of shared data vectors sizes.
+/// @param shared_sizes Lists of shared data vectors sizes.
+/// @param shared_gl_types Lists of shared data types.
+/// @param shared_buffer_len Length of the shared data lists (number of vectors).
+/// @param shared_n Number of lists in shared_data.
+/// @param instance_sizes Lists of instance data vectors sizes.
+/// @param instance_gl_types Lists of instance data types.
+/// @param instance_buffer_len Length of the instance data lists (number of instances).
+/// @param instance_n Number of instance lists.
+/// @note The instance lists are empty. They're stored one after the other in vao->vbo_instanced
+/// and written with vbo_update.
+/// @return The created InstancedVAO.
+InstancedVAO *vao_create_instanced_dynamic(
+	void** shared_data, int* shared_sizes, int* shared_gl_types, size_t shared_buffer_len, int shared_n,
+	int* instance_sizes, int* instance_gl_types, size_t instance_buffer_len, int instance_n
+) {
+
+	// Malloc the VAO structure.
+	InstancedVAO *vao = malloc(sizeof(InstancedVAO));
+	if (!vao) {
+		fprintf(stderr, "[ARGUS]: error: failed to malloc a VAO structure !\n");
+		return NULL;
+	}
+	vao->size = instance_buffer_len;
+	
+	// Creates the shared VBO.
+	int shared_type_sizes[shared_n];
+	for (int i = 0; i < shared_n; ++i) shared_type_sizes[i] = sizeFromGLType(shared_gl_types[i]);
+	vao->vbo_shared = vbo_create(shared_data, shared_sizes, shared_type_sizes, shared_buffer_len, shared_n);
+	if (!vao->vbo_shared) {
+		fprintf(stderr, "[ARGUS]: error: unable to create a shader VBO for an InstanceVAO !\n");
+		free(vao);
+		return NULL;
+	}
+
+	// Creates the instance VBO.
+	int instance_type_sizes[instance_n];
+	for (int i = 0; i < instance_n; ++i) instance_type_sizes[i] = sizeFromGLType(instance_gl_types[i]);
+	vao->vbo_instanced = vbo_create_dynamic(instance_sizes, instance_type_sizes, instance_buffer_len, instance_n);
+	if (!vao->vbo_instanced) {
+		fprintf(stderr, "[ARGUS]: error: unable to create an instance VBO for an InstanceVAO !\n");
+		vbo_free(&vao->vbo_shared);
+		free(vao);
+		return NULL;
+	}
+
+	// Creates the VAO and links the VBO to it.
+	vao_link_instanced(vao, 
+		shared_sizes, shared_gl_types, shared_type_sizes, shared_buffer_len, shared_n,
+		instance_sizes, instance_gl_types, instance_type_sizes, instance_buffer_len, instance_n
+	);
 	return vao;
 }
 
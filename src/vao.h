@@ -27,6 +27,9 @@ typedef struct {
 // Constructs a VAO using the given parameters.
 VAO *vao_create(void** data, int* sizes, int* gl_types, size_t buffer_len, int n);
 
+// Constructs an empty VAO whose content is meant to be updated frequently.
+VAO *vao_create_dynamic(int* sizes, int* gl_types, size_t buffer_len, int n);
+
 // Frees the memory allocated for a VAO.
 void vao_free(VAO **p_vao);
 
@@ -41,6 +44,12 @@ InstancedVAO *vao_create_instanced(
 	void** instance_data, int* instance_sizes, int* instance_gl_types, size_t instance_buffer_len, int instance_n
 );
 
+// Constructs an InstancedVAO whose instance data is meant to be updated frequently.
+InstancedVAO *vao_create_instanced_dynamic(
+	void** shared_data, int* shared_sizes, int* shared_gl_types, size_t shared_buffer_len, int shared_n,
+	int* instance_sizes, int* instance_gl_types, size_t instance_buffer_len, int instance_n
+);
+
 // Frees the memory allocated for a InstancedVAO.
 void vao_free_instanced(InstancedVAO **p_vao);
 
@@ -45,6 +45,36 @@ VBO *vbo_create(void** data, int* sizes, int* type_sizes, size_t buffer_len, int
 	return vbo;
 }
 
+/// @brief Constructs an empty VBO meant to be updated frequently.
+/// @param sizes Lists of data vectors sizes.
+/// @param type_sizes Lists of data types sizes.
+/// @param buffer_len Length of the data lists (number of vectors).
+/// @param n Number of lists.
+/// @note The lists are stored one after the other, like in vbo_create.
+/// @note The content of the VBO is undefined until it is written with vbo_update.
+/// @return The created VBO.
+VBO *vbo_create_dynamic(int* sizes, int* type_sizes, size_t buffer_len, int n) {
+
+	// Malloc the VBO structure.
+	VBO *vbo = malloc(sizeof(VBO));
+	if (!vbo) {
+		fprintf(stderr, "[ARGUS]: error: failed to malloc a VBO structure !\n");
+		return NULL;
+	}
+	glGenBuffers(1, &vbo->vbo_id);
+	vbo->size = buffer_len;
+
+	// Calculate the total size.
+	GLsizeiptr data_size = 0;
+	for (int i = 0; i < n; i++) data_size += sizes[i] * type_sizes[i] * buffer_len;
+
+	// Bind the VBO, allocates its storage, then unbind it.
+	vbo_bind(vbo);
+		glBufferData(GL_ARRAY_BUFFER, data_size, 0, GL_DYNAMIC_DRAW);
+	vbo_bind(NULL);
+	return vbo;
+}
+
 /// @brief Frees the memory allocated for a VBO.
 /// @param p_vbo A pointer to the pointer of the VBO to be freed. Cannot be NULL.
 /// @note After freeing, the pointer *p_vbo is set to NULL to avoid double-free.
@@ -63,3 +93,15 @@ void vbo_bind(VBO *vbo) {
 	if (vbo) glBindBuffer(GL_ARRAY_BUFFER, vbo->vbo_id);
 	else glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
+
+/// @brief Overwrites a part of the content of a VBO.
+/// @param vbo The VBO to update.
+/// @param offset The offset in bytes of the first byte to overwrite.
+/// @param size The number of bytes to overwrite.
+/// @param data The new data. Must be at least size bytes long.
+void vbo_update(VBO *vbo, size_t offset, size_t size, const void *data) {
+	if (!size) return;
+	vbo_bind(vbo);
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	vbo_bind(NULL);
+}
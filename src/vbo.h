@@ -16,8 +16,14 @@ typedef struct {
 // Constructs a VBO using the given parameters.
 VBO *vbo_create(void** data, int* sizes, int* type_sizes, size_t buffer_len, int n);
 
+// Constructs an empty VBO meant to be updated frequently.
+VBO *vbo_create_dynamic(int* sizes, int* type_sizes, size_t buffer_len, int n);
+
 // Frees the memory allocated for a VBO.
 void vbo_free(VBO **p_vbo);
 
 // Binds a VBO.
 void vbo_bind(VBO *vbo);
+
+// Overwrites a part of the content of a VBO.
+void vbo_update(VBO *vbo, size_t offset, size_t size, const void *data);
@@ -0,0 +1,160 @@
+#include "vertex_arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vao.h"
+
+
+// Number of vertices of the vertex arena when it is created.
+#define VERTEXARENA_MIN_CAP (1<<16)
+
+
+// Vertices of the curves of the window.
+static VAO *arena = NULL;				///< The VAO holding the x-axis values list then the y-axis values list.
+static size_t used = 0;					///< The number of vertices before the end of the last allocated block.
+static ArenaBlock *free_blocks = NULL;	///< The released blocks before used, sorted by first vertex.
+static size_t free_size = 0;			///< The number of released blocks.
+static size_t free_cap = 0;				///< The number of released blocks the buffer can hold.
+
+
+
+/// @brief Grows the vertex arena so that it can hold a given number of vertices.
+/// @param len The number of vertices the arena must hold.
+/// @return false if there was an error.
+/// @note The allocated vertices are copied into the new VBO on the GPU, so the blocks keep their vertices.
+static bool vertexarena_grow(size_t len) {
+	const size_t old_cap = arena ? arena->size : 0;
+	size_t cap = old_cap ? 2*old_cap : VERTEXARENA_MIN_CAP;
+	while (cap < len) cap *= 2;
+	int sizes[2] = {1,1};
+	int gl_types[2] = {GL_FLOAT,GL_FLOAT};
+	VAO *vao = vao_create_dynamic(sizes, gl_types, cap, 2);
+	if (!vao) {
+		fprintf(stderr, "[ARGUS]: error: unable to create the VAO of the vertex arena!\n");
+		return false;
+	}
+	if (arena) {
+		glBindBuffer(GL_COPY_READ_BUFFER, arena->vbo->vbo_id);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, vao->vbo->vbo_id);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+				0, 0, used*sizeof(float));
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+				old_cap*sizeof(float), cap*sizeof(float), used*sizeof(float));
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		vao_free(&arena);
+	}
+	arena = vao;
+	return true;
+}
+
+/// @brief Removes a released block from the list.
+/// @param i The index of the block to remove.
+static void vertexarena_remove_free(size_t i) {
+	memmove(free_blocks+i, free_blocks+i+1, (free_size-i-1)*sizeof(ArenaBlock));
+	--free_size;
+}
+
+
+
+/// @brief Allocates a block of vertices in the vertex arena.
+/// @param block The block to allocate. It is released first if it was allocated.
+/// @param len The number of vertices of the block.
+/// @return false if there was an error.
+/// @note The first released block that is large enough is reused, otherwise the block is
+/// added after the others, growing the arena if needed.
+bool vertexarena_alloc(ArenaBlock *block, size_t len) {
+	vertexarena_release(block);
+	if (!len) return true;
+	for (size_t i = 0; i < free_size; ++i) {
+		if (free_blocks[i].len < len) continue;
+		*block = (ArenaBlock){free_blocks[i].first, len};
+		free_blocks[i].first += len;
+		free_blocks[i].len -= len;
+		if (!free_blocks[i].len) vertexarena_remove_free(i);
+		return true;
+	}
+	if ((!arena || used + len > arena->size) && !vertexarena_grow(used + len)) return false;
+	*block = (ArenaBlock){used, len};
+	used += len;
+	return true;
+}
+
+/// @brief Gives a block back to the vertex arena.
+/// @param block The block to release. It is set to ARENABLOCK_INIT.
+/// @note The block is merged with the released blocks around it, and the end of the arena
+/// is given back when the last block is released.
+void vertexarena_release(ArenaBlock *block) {
+	ArenaBlock merged = *block;
+	*block = ARENABLOCK_INIT;
+	if (!merged.len || !arena) return;
+
+	// Merges the block with its released neighbours.
+	size_t i = 0;
+	while (i < free_size && free_blocks[i].first < merged.first) ++i;
+	if (i > 0 && free_blocks[i-1].first + free_blocks[i-1].len == merged.first) {
+		merged.first = free_blocks[i-1].first;
+		merged.len += free_blocks[i-1].len;
+		vertexarena_remove_free(--i);
+	}
+	if (i < free_size && merged.first + merged.len == free_blocks[i].first) {
+		merged.len += free_blocks[i].len;
+		vertexarena_remove_free(i);
+	}
+	if (merged.first + merged.len == used) {
+		used = merged.first;
+		return;
+	}
+
+	// Inserts the block into the sorted list.
+	if (free_size == free_cap) {
+		const size_t cap = free_cap ? 2*free_cap : 16;
+		ArenaBlock *data = realloc(free_blocks, cap*sizeof(ArenaBlock));
+		if (!data) {
+			fprintf(stderr, "[ARGUS]: warning: unable to realloc the released blocks of the vertex arena!\n");
+			return;
+		}
+		free_blocks = data;
+		free_cap = cap;
+	}
+	memmove(free_blocks+i+1, free_blocks+i, (free_size-i)*sizeof(ArenaBlock));
+	free_blocks[i] = merged;
+	++free_size;
+}
+
+/// @brief Gets the VBO of the vertex arena.
+/// @return The VBO, or NULL if no block was allocated.
+/// @note The VBO changes when the arena grows, so it mustn't be kept across allocations.
+VBO *vertexarena_vbo(void) {
+	return arena ? arena->vbo : NULL;
+}
+
+/// @brief Gets the byte offsets of the x-axis and y-axis values of a block in the VBO of the vertex arena.
+/// @param block The block.
+/// @param x_offset Where to store the offset of the x-axis value of the first vertex of the block.
+/// @param y_offset Where to store the offset of the y-axis value of the first vertex of the block.
+void vertexarena_offsets(const ArenaBlock *block, size_t *x_offset, size_t *y_offset) {
+	const size_t cap = arena ? arena->size : 0;
+	*x_offset = block->first*sizeof(float);
+	*y_offset = (cap + block->first)*sizeof(float);
+}
+
+/// @brief Gets the OpenGL id of the VAO of the vertex arena.
+/// @return The id, or 0 if no block was allocated.
+/// @note The VAO links in_x to the x-axis values list and in_y to the y-axis values list,
+/// so the vertex i of the VAO is the vertex i of the arena.
+GLuint vertexarena_vao_id(void) {
+	return arena ? arena->vao_id : 0;
+}
+
+/// @brief Frees the vertex arena.
+/// @note The blocks must be released before, since they would refer to the next arena.
+void vertexarena_free(void) {
+	vao_free(&arena);
+	free(free_blocks);
+	free_blocks = NULL;
+	free_size = 0;
+	free_cap = 0;
+	used = 0;
+}
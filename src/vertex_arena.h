@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <GL/glew.h>
+#include "vbo.h"
+
+
+/// @struct ArenaBlock
+/// @brief A range of vertices of the vertex arena, owned by a curve.
+typedef struct {
+	size_t first;	///< The first vertex of the block.
+	size_t len;		///< The number of vertices of the block, 0 if it isn't allocated.
+} ArenaBlock;
+
+// An unallocated block.
+#define ARENABLOCK_INIT (ArenaBlock){0, 0}
+
+
+// Allocates a block of vertices in the vertex arena.
+bool vertexarena_alloc(ArenaBlock *block, size_t len);
+
+// Gives a block back to the vertex arena.
+void vertexarena_release(ArenaBlock *block);
+
+// Gets the VBO of the vertex arena.
+VBO *vertexarena_vbo(void);
+
+// Gets the byte offsets of the x-axis and y-axis values of a block in the VBO of the vertex arena.
+void vertexarena_offsets(const ArenaBlock *block, size_t *x_offset, size_t *y_offset);
+
+// Gets the OpenGL id of the VAO of the vertex arena.
+GLuint vertexarena_vao_id(void);
+
+// Frees the vertex arena.
+void vertexarena_free(void);
@@ -0,0 +1,67 @@
+#include "wakeup.h"
+
+#include <stdio.h>
+#include <SDL2/SDL.h>
+
+
+
+// The type of the wake-up event, (uint32_t)-1 until it is registered.
+// Published by the render thread and read by the producers, so it is atomic.
+static _Atomic uint32_t wakeup_type = (uint32_t)-1;
+
+// Coalescing of the notifications. A single wake-up event is pending at a time.
+static atomic_bool posted = false;		///< true while a wake-up event waits in the SDL queue.
+static atomic_uint_fast64_t posted_time;	///< Performance counter value when the pending event was sent.
+
+
+
+/// @brief Registers the SDL event used to wake the render loop up.
+/// @return false if there was an error.
+/// @note The event is registered only once, so this can be called before each render.
+/// @note An event still pending when the previous render ended was dropped with the SDL queue,
+/// so the coalescing flag is cleared here, otherwise no event would ever be sent again.
+bool wakeup_init() {
+	atomic_store(&posted, false);
+	if (atomic_load_explicit(&wakeup_type, memory_order_acquire) != (uint32_t)-1) return true;
+	const uint32_t type = SDL_RegisterEvents(1);
+	if (type == (uint32_t)-1) {
+		fprintf(stderr, "[ARGUS]: error: unable to register the wake-up event: %s.\n", SDL_GetError());
+		return false;
+	}
+	atomic_store_explicit(&wakeup_type, type, memory_order_release);
+	return true;
+}
+
+/// @brief Checks if an SDL event is a wake-up event.
+/// @param type The type of the event.
+/// @return true if it is a wake-up event.
+bool wakeup_is(uint32_t type) {
+	const uint32_t wakeup = atomic_load_explicit(&wakeup_type, memory_order_acquire);
+	return wakeup != (uint32_t)-1 && type == wakeup;
+}
+
+/// @brief Flags new data and wakes the render loop up from any thread.
+/// @param dirty The dirty flag of the graph that received data, or NULL.
+/// @note The render loop blocks until an event arrives, so producers of new data call this 
+/// to have it rendered. Does nothing but setting the flag if the event isn't registered.
+/// @note The notifications are coalesced: no event is sent while the previous one 
+/// hasn't been taken, so a burst of pushes costs a single wake-up.
+void wakeup_notify(atomic_bool *dirty) {
+	if (dirty) atomic_store_explicit(dirty, true, memory_order_release);
+	const uint32_t type = atomic_load_explicit(&wakeup_type, memory_order_acquire);
+	if (type == (uint32_t)-1) return;
+	if (atomic_exchange(&posted, true)) return;
+	atomic_store(&posted_time, SDL_GetPerformanceCounter());
+	SDL_Event event = {.type = type};
+	SDL_PushEvent(&event);
+}
+
+/// @brief Acknowledges the pending wake-up event and returns when it was sent.
+/// @return The performance counter value when the event was sent.
+/// @note Must be called by the render loop when it receives the event, before it reads the dirty flags,
+/// so that the data notified after that sends a new event.
+uint64_t wakeup_take() {
+	const uint64_t time = atomic_load(&posted_time);
+	atomic_store(&posted, false);
+	return time;
+}
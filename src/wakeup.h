@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+
+
+// Registers the SDL event used to wake the render loop up.
+bool wakeup_init();
+
+// Checks if an SDL event is a wake-up event.
+bool wakeup_is(uint32_t type);
+
+// Flags new data and wakes the render loop up from any thread.
+void wakeup_notify(atomic_bool *dirty);
+
+// Acknowledges the pending wake-up event and returns when it was sent.
+uint64_t wakeup_take();